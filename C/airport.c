@@ -21,6 +21,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "airport.h"
 
 
@@ -130,19 +132,19 @@ void initAirport(Airport* airport,
         return;
     }
 
-    airport->gpsId = (char *) malloc(sizeof(char *) * strlen(gpsId));
+    airport->gpsId = (char *) malloc(sizeof(char) * (strlen(gpsId) + 1));
     strcpy(airport->gpsId, gpsId);
 
-    airport->type = (char *) malloc(sizeof(char *) * strlen(type));
+    airport->type = (char *) malloc(sizeof(char) * (strlen(type) + 1));
     strcpy(airport->type, type);
 
-    airport->name = (char *) malloc(sizeof(char *) * strlen(name));
+    airport->name = (char *) malloc(sizeof(char) * (strlen(name) + 1));
     strcpy(airport->name, name);
 
-    airport->city = (char *) malloc(sizeof(char *) * strlen(city));
+    airport->city = (char *) malloc(sizeof(char) * (strlen(city) + 1));
     strcpy(airport->city, city);
 
-    airport->countryAbbrv = (char *) malloc(sizeof(char *) * strlen(countryAbbrv));
+    airport->countryAbbrv = (char *) malloc(sizeof(char) * (strlen(countryAbbrv) + 1));
     strcpy(airport->countryAbbrv, countryAbbrv);
 
     airport->latitude = latitude;
@@ -417,6 +419,13 @@ int cmpByNameDesc(const void* a, const void* b) {
 }
 
 
+int cmpByCountry(const void* a, const void* b) {
+  const char* aCountry = ((const Airport*)a)->countryAbbrv;
+  const char* bCountry = ((const Airport*)b)->countryAbbrv;
+
+  return strcmp(aCountry, bCountry);
+}
+
 int cmpByCountryCity(const void* a, const void* b) {
   const Airport* aAirport = (const Airport*)a;
   const Airport* bAirport = (const Airport*)b;
@@ -513,4 +522,416 @@ Airport* filterBySize(Airport *airports, int n, char *size, int *output_size) {
   
   *output_size = found;
   return result;
-}
\ No newline at end of file
+}
+
+/**
+ * The fewest airports worth handing to a thread of their own when
+ * reducing groups.
+ */
+#define GROUP_MIN_AIRPORTS_PER_THREAD 4096
+
+/**
+ * The work of one thread in groupAirports(): reduce groups
+ * [firstGroup, lastGroup), whose runs are given by runStarts, over
+ * structure-of-arrays copies of the sorted airports.
+ */
+typedef struct {
+  const Airport *sorted;
+  const double *latitudes;
+  const double *longitudes;
+  const int *elevations;
+  double *scratch;
+  const int *runStarts;
+  AirportGroup *groups;
+  AirportGroupBy groupBy;
+  int firstGroup;
+  int lastGroup;
+} GroupTask;
+
+static int cmpDoubles(const void* a, const void* b) {
+  const double aVal = *(const double*)a;
+  const double bVal = *(const double*)b;
+
+  if (aVal > bVal) return 1;
+  else if (aVal < bVal) return -1;
+  else return 0;
+}
+
+/**
+ * Finds the smallest longitude interval holding all n longitudes.
+ * The interval is the complement of the largest gap between
+ * neighbouring longitudes around the circle, so when it crosses the
+ * antimeridian *min is greater than *max.  lons is sorted in place.
+ */
+static void longitudeInterval(double *lons, int n, double *min, double *max) {
+  qsort(lons, n, sizeof(double), cmpDoubles);
+
+  // the gap that wraps from the last longitude back to the first
+  double largestGap = lons[0] + 360 - lons[n - 1];
+  *min = lons[0];
+  *max = lons[n - 1];
+  for (int i = 1; i < n; i++) {
+    if (lons[i] - lons[i - 1] > largestGap) {
+      largestGap = lons[i] - lons[i - 1];
+      *min = lons[i];
+      *max = lons[i - 1];
+    }
+  }
+}
+
+static void* reduceGroups(void *arg) {
+  const GroupTask *task = (const GroupTask *) arg;
+
+  for (int g = task->firstGroup; g < task->lastGroup; g++) {
+    int start = task->runStarts[g];
+    int end = task->runStarts[g + 1];
+    AirportGroup *group = &task->groups[g];
+    const Airport *first = &task->sorted[start];
+    group->countryAbbrv = task->groupBy == GROUP_BY_TYPE ? NULL : first->countryAbbrv;
+    group->city = task->groupBy == GROUP_BY_COUNTRY_CITY ? first->city : NULL;
+    group->type = task->groupBy == GROUP_BY_TYPE ? first->type : NULL;
+    group->count = end - start;
+
+    // min/max are written as selects over plain arrays so the
+    // compiler can keep them out of branches
+    int minElevation = task->elevations[start];
+    int maxElevation = task->elevations[start];
+    double minLatitude = task->latitudes[start];
+    double maxLatitude = task->latitudes[start];
+    double elevationSum = 0;
+    for (int i = start; i < end; i++) {
+      int elevation = task->elevations[i];
+      double latitude = task->latitudes[i];
+      minElevation = elevation < minElevation ? elevation : minElevation;
+      maxElevation = elevation > maxElevation ? elevation : maxElevation;
+      minLatitude = latitude < minLatitude ? latitude : minLatitude;
+      maxLatitude = latitude > maxLatitude ? latitude : maxLatitude;
+      elevationSum += elevation;
+    }
+    group->minElevationFeet = minElevation;
+    group->maxElevationFeet = maxElevation;
+    group->minLatitude = minLatitude;
+    group->maxLatitude = maxLatitude;
+    group->meanElevationFeet = elevationSum / group->count;
+
+    // the centroid is the mean of the unit vectors of each airport,
+    // projected back onto the sphere
+    double x = 0, y = 0, z = 0;
+    for (int i = start; i < end; i++) {
+      double lat = degreesToRadians(task->latitudes[i]);
+      double lon = degreesToRadians(task->longitudes[i]);
+      x += cos(lat) * cos(lon);
+      y += cos(lat) * sin(lon);
+      z += sin(lat);
+    }
+    group->centroidLatitude = atan2(z, sqrt(x * x + y * y)) * 180 / M_PI;
+    group->centroidLongitude = atan2(y, x) * 180 / M_PI;
+
+    // each group only touches its own slice of the scratch space
+    double *lons = task->scratch + start;
+    memcpy(lons, task->longitudes + start, sizeof(double) * group->count);
+    longitudeInterval(lons, group->count, &group->minLongitude, &group->maxLongitude);
+  }
+
+  return NULL;
+}
+
+AirportGroup* groupAirports(const Airport *airports, int n, AirportGroupBy groupBy, int *output_size) {
+  if (airports == NULL || n <= 0 || output_size == NULL) {
+    return NULL;
+  }
+
+  int (*cmp)(const void*, const void*);
+  switch (groupBy) {
+    case GROUP_BY_COUNTRY: cmp = cmpByCountry; break;
+    case GROUP_BY_COUNTRY_CITY: cmp = cmpByCountryCity; break;
+    case GROUP_BY_TYPE: cmp = cmpByType; break;
+    default:
+      fprintf(stderr, "ERROR invalid input (groupBy) \n");
+      return NULL;
+  }
+
+  // sort a shallow copy so that each group is one contiguous run
+  Airport *sorted = (Airport *) malloc(sizeof(Airport) * n);
+  memcpy(sorted, airports, sizeof(Airport) * n);
+  qsort(sorted, n, sizeof(Airport), cmp);
+
+  int *runStarts = (int *) malloc(sizeof(int) * (n + 1));
+  int numGroups = 0;
+  for (int i = 0; i < n; i++) {
+    if (i == 0 || cmp(&sorted[i - 1], &sorted[i]) != 0) {
+      runStarts[numGroups++] = i;
+    }
+  }
+  runStarts[numGroups] = n;
+
+  double *latitudes = (double *) malloc(sizeof(double) * n);
+  double *longitudes = (double *) malloc(sizeof(double) * n);
+  double *scratch = (double *) malloc(sizeof(double) * n);
+  int *elevations = (int *) malloc(sizeof(int) * n);
+  for (int i = 0; i < n; i++) {
+    latitudes[i] = sorted[i].latitude;
+    longitudes[i] = sorted[i].longitude;
+    elevations[i] = sorted[i].elevationFeet;
+  }
+
+  AirportGroup *groups = (AirportGroup *) malloc(sizeof(AirportGroup) * numGroups);
+
+  long numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (numThreads > n / GROUP_MIN_AIRPORTS_PER_THREAD) numThreads = n / GROUP_MIN_AIRPORTS_PER_THREAD;
+  if (numThreads > numGroups) numThreads = numGroups;
+  if (numThreads < 1) numThreads = 1;
+
+  // split the groups into runs of about n / numThreads airports each
+  GroupTask *tasks = (GroupTask *) malloc(sizeof(GroupTask) * numThreads);
+  int g = 0;
+  for (int t = 0; t < numThreads; t++) {
+    GroupTask task = {sorted, latitudes, longitudes, elevations, scratch, runStarts, groups, groupBy, g, g};
+    long target = (long) n * (t + 1) / numThreads;
+    while (g < numGroups && (runStarts[g] < target || t == numThreads - 1)) {
+      g++;
+    }
+    task.lastGroup = g;
+    tasks[t] = task;
+  }
+
+  pthread_t *threads = (pthread_t *) malloc(sizeof(pthread_t) * numThreads);
+  int *running = (int *) calloc(numThreads, sizeof(int));
+  for (int t = 1; t < numThreads; t++) {
+    running[t] = pthread_create(&threads[t], NULL, reduceGroups, &tasks[t]) == 0;
+    if (!running[t]) {
+      // fall back to reducing this share on the calling thread
+      reduceGroups(&tasks[t]);
+    }
+  }
+  reduceGroups(&tasks[0]);
+  for (int t = 1; t < numThreads; t++) {
+    if (running[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+
+  free(threads);
+  free(running);
+  free(tasks);
+  free(latitudes);
+  free(longitudes);
+  free(scratch);
+  free(elevations);
+  free(runStarts);
+  free(sorted);
+  *output_size = numGroups;
+  return groups;
+}
+
+void printAirportGroups(const AirportGroup *groups, int n) {
+  for (int i = 0; i < n; i++) {
+    const AirportGroup *g = &groups[i];
+    char key[200];
+    if (g->type != NULL) {
+      snprintf(key, sizeof(key), "%s", g->type);
+    } else if (g->city != NULL) {
+      snprintf(key, sizeof(key), "%s/%s", g->countryAbbrv, g->city);
+    } else {
+      snprintf(key, sizeof(key), "%s", g->countryAbbrv);
+    }
+    printf("%-20s %3d %6d %6d %8.1f [%.2f, %.2f] [%.2f, %.2f] (%.2f, %.2f)\n", key, g->count,
+           g->minElevationFeet, g->maxElevationFeet, g->meanElevationFeet,
+           g->minLatitude, g->maxLatitude, g->minLongitude, g->maxLongitude,
+           g->centroidLatitude, g->centroidLongitude);
+  }
+
+  return;
+}
+
+int batchAirDistance(const double *latitudes,
+                     const double *longitudes,
+                     int n,
+                     double originLatitude,
+                     double originLongitude,
+                     double *distances) {
+  if (latitudes == NULL || longitudes == NULL || distances == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid inputs\n");
+    return -1;
+  }
+  if (originLatitude < -90 || originLatitude > 90 || originLongitude < -180 || originLongitude > 180) {
+    fprintf(stderr, "ERROR invalid origin\n");
+    return -1;
+  }
+
+  // the origin terms are the same for every point
+  const double RADIUS = 6371;
+  double lat1 = degreesToRadians(originLatitude);
+  double lon1 = degreesToRadians(originLongitude);
+  double sinLat1 = sin(lat1);
+  double cosLat1 = cos(lat1);
+
+  for (int i = 0; i < n; i++) {
+    if (latitudes[i] < -90 || latitudes[i] > 90 || longitudes[i] < -180 || longitudes[i] > 180) {
+      distances[i] = -1;
+      continue;
+    }
+    double lat2 = degreesToRadians(latitudes[i]);
+    double lon2 = degreesToRadians(longitudes[i]);
+    // rounding can push the cosine just past +-1 for equal or antipodal points
+    double c = sinLat1*sin(lat2) + cosLat1*cos(lat2)*cos(lon1-lon2);
+    c = c > 1 ? 1 : (c < -1 ? -1 : c);
+    distances[i] = acos(c) * RADIUS;
+  }
+
+  return 0;
+}
+
+typedef struct {
+  double distance;
+  int row;
+} DistanceEntry;
+
+static int cmpDistanceEntry(const void* a, const void* b) {
+  const DistanceEntry* _a = (const DistanceEntry*)a;
+  const DistanceEntry* _b = (const DistanceEntry*)b;
+
+  if (_a->distance > _b->distance) return 1;
+  else if (_a->distance < _b->distance) return -1;
+  else return _a->row - _b->row;
+}
+
+int sortByAirDistance(const double *latitudes,
+                      const double *longitudes,
+                      int n,
+                      double originLatitude,
+                      double originLongitude,
+                      int *order) {
+  if (order == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid inputs\n");
+    return -1;
+  }
+
+  double *distances = (double *) malloc(sizeof(double) * (n > 0 ? n : 1));
+  if (batchAirDistance(latitudes, longitudes, n, originLatitude, originLongitude, distances) != 0) {
+    free(distances);
+    return -1;
+  }
+
+  DistanceEntry *entries = (DistanceEntry *) malloc(sizeof(DistanceEntry) * (n > 0 ? n : 1));
+  for (int i = 0; i < n; i++) {
+    entries[i].distance = distances[i];
+    entries[i].row = i;
+  }
+  qsort(entries, n, sizeof(DistanceEntry), cmpDistanceEntry);
+  for (int i = 0; i < n; i++) {
+    order[i] = entries[i].row;
+  }
+
+  free(entries);
+  free(distances);
+  return 0;
+}
+
+int filterByRange(const double *values, int n, double min, double max, int *rows) {
+  if (values == NULL || rows == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid inputs\n");
+    return -1;
+  }
+
+  int found = 0;
+  for (int i = 0; i < n; i++) {
+    if (values[i] >= min && values[i] <= max) {
+      rows[found++] = i;
+    }
+  }
+  return found;
+}
+
+typedef struct {
+  double key;
+  int row;
+  int position;
+} DoubleKeyEntry;
+
+static int cmpDoubleKeyEntry(const void* a, const void* b) {
+  const DoubleKeyEntry* _a = (const DoubleKeyEntry*)a;
+  const DoubleKeyEntry* _b = (const DoubleKeyEntry*)b;
+
+  if (_a->key > _b->key) return 1;
+  else if (_a->key < _b->key) return -1;
+  else return _a->position - _b->position;
+}
+
+int sortByDoubleKey(const double *keys, int n, int descending, int *order) {
+  if (keys == NULL || order == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid inputs\n");
+    return -1;
+  }
+
+  // ties fall back to the incoming position, which keeps the sort stable
+  DoubleKeyEntry *entries = (DoubleKeyEntry *) malloc(sizeof(DoubleKeyEntry) * (n > 0 ? n : 1));
+  for (int i = 0; i < n; i++) {
+    entries[i].key = descending ? -keys[order[i]] : keys[order[i]];
+    entries[i].row = order[i];
+    entries[i].position = i;
+  }
+  qsort(entries, n, sizeof(DoubleKeyEntry), cmpDoubleKeyEntry);
+  for (int i = 0; i < n; i++) {
+    order[i] = entries[i].row;
+  }
+
+  free(entries);
+  return 0;
+}
+
+typedef struct {
+  const unsigned short *chars;
+  int length;
+  int row;
+  int position;
+} StringKeyEntry;
+
+static int cmpStringKeys(const StringKeyEntry* a, const StringKeyEntry* b) {
+  int length = a->length < b->length ? a->length : b->length;
+  for (int i = 0; i < length; i++) {
+    if (a->chars[i] != b->chars[i]) {
+      return a->chars[i] < b->chars[i] ? -1 : 1;
+    }
+  }
+  return a->length - b->length;
+}
+
+static int cmpStringKeyEntry(const void* a, const void* b) {
+  const StringKeyEntry* _a = (const StringKeyEntry*)a;
+  const StringKeyEntry* _b = (const StringKeyEntry*)b;
+
+  int result = cmpStringKeys(_a, _b);
+  return result != 0 ? result : _a->position - _b->position;
+}
+
+static int cmpStringKeyEntryDesc(const void* a, const void* b) {
+  const StringKeyEntry* _a = (const StringKeyEntry*)a;
+  const StringKeyEntry* _b = (const StringKeyEntry*)b;
+
+  int result = cmpStringKeys(_b, _a);
+  return result != 0 ? result : _a->position - _b->position;
+}
+
+int sortByStringKey(const unsigned short *chars, const int *offsets, int n, int descending, int *order) {
+  if (chars == NULL || offsets == NULL || order == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid inputs\n");
+    return -1;
+  }
+
+  StringKeyEntry *entries = (StringKeyEntry *) malloc(sizeof(StringKeyEntry) * (n > 0 ? n : 1));
+  for (int i = 0; i < n; i++) {
+    int row = order[i];
+    entries[i].chars = chars + offsets[row];
+    entries[i].length = offsets[row + 1] - offsets[row];
+    entries[i].row = row;
+    entries[i].position = i;
+  }
+  qsort(entries, n, sizeof(StringKeyEntry), descending ? cmpStringKeyEntryDesc : cmpStringKeyEntry);
+  for (int i = 0; i < n; i++) {
+    order[i] = entries[i].row;
+  }
+
+  free(entries);
+  return 0;
+}
@@ -26,6 +26,43 @@ typedef struct {
   char *countryAbbrv;
 } Airport;
 
+/**
+ * The fields an airport table can be grouped by when
+ * summarizing it with groupAirports().
+ */
+typedef enum {
+  GROUP_BY_COUNTRY,
+  // reads city, so it cannot be used once releaseAirportStringFields()
+  // (stringStore.h) has set it to NULL
+  GROUP_BY_COUNTRY_CITY,
+  GROUP_BY_TYPE
+} AirportGroupBy;
+
+/**
+ * Summary statistics for one group of airports.  The key
+ * fields that are not part of the grouping are NULL.  Key
+ * strings point into the Airport array that was grouped, so
+ * they are only valid as long as those airports are.  The
+ * longitude range is the smallest one holding every airport
+ * of the group; minLongitude > maxLongitude means it crosses
+ * the antimeridian.
+ */
+typedef struct {
+  const char *countryAbbrv;
+  const char *city;
+  const char *type;
+  int count;
+  int minElevationFeet;
+  int maxElevationFeet;
+  double meanElevationFeet;
+  double minLatitude;
+  double maxLatitude;
+  double minLongitude;
+  double maxLongitude;
+  double centroidLatitude;
+  double centroidLongitude;
+} AirportGroup;
+
 /**
  * A factory function to create a new Airport with the given
  * attributes.  This function should make *deep* copies of each
@@ -58,12 +95,16 @@ void initAirport(Airport* airport,
 /**
  * Constructs a new string representation of the given
  * Airport structure.
+ * Reads gpsId, name and city, so it must not be used once
+ * releaseAirportStringFields() (stringStore.h) has set them to NULL.
  */
 char* airportToString(const Airport* a);
 
 /**
  * Prints all the airports in the given array of n
- * Airports.
+ * Airports.  Like airportToString(), it reads gpsId, name and city,
+ * so use printAirportsFromStrings() (stringStore.h) instead once
+ * releaseAirportStringFields() has set them to NULL.
  */
 void printAirports(Airport *airports, int n);
 
@@ -122,7 +163,9 @@ int cmpByType(const void* a, const void* b);
 
 /**
  * A comparator function that orders the two Airport structures by
- * their name in lexicographic order.
+ * their name in lexicographic order.  Reads name, so it must not be
+ * used once releaseAirportStringFields() (stringStore.h) has set it
+ * to NULL; use airportStringsCmpByName() instead.
  * 
  * @param a a pointer to an Airport structure
  * @param b a pointer to an Airport structure
@@ -131,13 +174,23 @@ int cmpByName(const void* a, const void* b);
 
 /**
  * A comparator function that orders the two Airport structures by
- * their name in reverse lexicographic order.
+ * their name in reverse lexicographic order.  Like cmpByName(), it
+ * must not be used once releaseAirportStringFields() has run.
  * 
  * @param a a pointer to an Airport structure
  * @param b a pointer to an Airport structure
  */
 int cmpByNameDesc(const void* a, const void* b);
 
+/**
+ * A comparator function that orders the two Airport structures by
+ * their country.
+ * 
+ * @param a a pointer to an Airport structure
+ * @param b a pointer to an Airport structure
+ */
+int cmpByCountry(const void* a, const void* b);
+
 /**
  * A comparator function that orders the two Airport structures first by
  * country, then by city
@@ -185,7 +238,8 @@ void generateReports(Airport *airports, int n);
 void generateReports(Airport *airports, int n);
 
 /**
- * Get Airports that are in city.
+ * Get Airports that are in city.  Reads city, so it must not be used
+ * once releaseAirportStringFields() (stringStore.h) has set it to NULL.
  * 
  * @param airports a pointer to an array of Airport structures
  * @param n the number of elements in the array
@@ -205,4 +259,95 @@ Airport* filterByCity(Airport *airports, int n, char *city, char* countryAbbr, i
 Airport* filterBySize(Airport *airports, int n, char *size, int *output_size);
 
 
+/**
+ * Groups the airports by the given key and computes, for each group,
+ * the number of airports, the min/max/mean elevation, the latitude/longitude
+ * bounding box and the geographic centroid.  Groups are returned in
+ * key order.  Large tables are reduced on several threads, one run
+ * of groups each.  The given array is not modified.
+ * 
+ * @param airports a pointer to an array of Airport structures
+ * @param n the number of elements in the array
+ * @param groupBy the key to group by
+ * @param output_size int passed by ref, will be the number of groups
+ * @return a newly allocated array of groups, or NULL if there are none
+ */
+AirportGroup* groupAirports(const Airport *airports, int n, AirportGroupBy groupBy, int *output_size);
+
+/**
+ * Prints all the groups in the given array of n
+ * AirportGroups.
+ */
+void printAirportGroups(const AirportGroup *groups, int n);
+
+/**
+ * Computes the air distance, in kilometers, from the given origin to
+ * each of the n points given as parallel latitude/longitude arrays.
+ * Points outside the valid ranges get a distance of -1.
+ *
+ * @param latitudes an array of n latitudes
+ * @param longitudes an array of n longitudes
+ * @param distances an array of n doubles the distances are written to
+ * @return 0 on success, -1 on invalid input
+ */
+int batchAirDistance(const double *latitudes,
+                     const double *longitudes,
+                     int n,
+                     double originLatitude,
+                     double originLongitude,
+                     double *distances);
+
+/**
+ * Orders the n points given as parallel latitude/longitude arrays by
+ * their air distance from the given origin, closest first.  Each
+ * distance is computed once rather than once per comparison.
+ *
+ * @param latitudes an array of n latitudes
+ * @param longitudes an array of n longitudes
+ * @param order an array of n ints the sorted point positions are written to
+ * @return 0 on success, -1 on invalid input
+ */
+int sortByAirDistance(const double *latitudes,
+                      const double *longitudes,
+                      int n,
+                      double originLatitude,
+                      double originLongitude,
+                      int *order);
+
+/**
+ * Finds the positions of the values that are in [min, max].
+ *
+ * @param values an array of n values
+ * @param rows an array of (up to) n ints the matching positions are written to
+ * @return the number of matching positions, or -1 on invalid input
+ */
+int filterByRange(const double *values, int n, double min, double max, int *rows);
+
+/**
+ * Stably sorts the rows in order by their key.  order holds n row
+ * numbers on entry (usually the current order of a table) and is
+ * reordered so keys[order[i]] is ascending, or descending if
+ * descending is non-zero.  Rows with equal keys keep their relative
+ * order, like a stable sort of the table itself.
+ *
+ * @param keys the key of each row
+ * @param order an array of n row numbers, each in [0, n), sorted in place
+ * @return 0 on success, -1 on invalid input
+ */
+int sortByDoubleKey(const double *keys, int n, int descending, int *order);
+
+/**
+ * Stably sorts the rows in order by a string key, in the same way as
+ * sortByDoubleKey().  The key of row r is the 16-bit code units
+ * chars[offsets[r]] up to chars[offsets[r + 1]], compared unit by unit
+ * with a shorter key first when one is a prefix of the other.  Keys
+ * can be case-folded by the caller for case-insensitive orders.
+ *
+ * @param chars the code units of every key, back to back
+ * @param offsets n + 1 offsets into chars
+ * @param order an array of n row numbers, each in [0, n), sorted in place
+ * @return 0 on success, -1 on invalid input
+ */
+int sortByStringKey(const unsigned short *chars, const int *offsets, int n, int descending, int *order);
+
 #endif // AIRPORT_H
\ No newline at end of file
@@ -0,0 +1,261 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method definitions for sorted Airport indexes
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "airportIndex.h"
+
+typedef struct {
+  double key;
+  int row;
+} IndexEntry;
+
+static int cmpIndexEntry(const void* a, const void* b) {
+  const IndexEntry* _a = (const IndexEntry*)a;
+  const IndexEntry* _b = (const IndexEntry*)b;
+
+  if (_a->key > _b->key) return 1;
+  else if (_a->key < _b->key) return -1;
+  else return _a->row - _b->row;
+}
+
+static int cmpRows(const void* a, const void* b) {
+  return *(const int *)a - *(const int *)b;
+}
+
+static double fieldValue(const Airport *a, AirportIndexField field) {
+  switch (field) {
+    case INDEX_LATITUDE: return a->latitude;
+    case INDEX_LONGITUDE: return a->longitude;
+    default: return a->elevationFeet;
+  }
+}
+
+AirportIndex* createAirportIndex(const Airport *airports, int n, AirportIndexField field) {
+  if (airports == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid input (airports) \n");
+    return NULL;
+  }
+
+  int size = n > 0 ? n : 1;
+  IndexEntry *entries = (IndexEntry *) malloc(sizeof(IndexEntry) * size);
+  for (int i = 0; i < n; i++) {
+    entries[i].key = fieldValue(&airports[i], field);
+    entries[i].row = i;
+  }
+  qsort(entries, n, sizeof(IndexEntry), cmpIndexEntry);
+
+  // keys and rows are kept in separate arrays so the binary search
+  // only touches the keys
+  AirportIndex *index = (AirportIndex *) malloc(sizeof(AirportIndex));
+  index->field = field;
+  index->n = n;
+  index->keys = (double *) malloc(sizeof(double) * size);
+  index->rows = (int *) malloc(sizeof(int) * size);
+  for (int i = 0; i < n; i++) {
+    index->keys[i] = entries[i].key;
+    index->rows[i] = entries[i].row;
+  }
+
+  free(entries);
+  return index;
+}
+
+int airportIndexLowerBound(const AirportIndex *index, double key) {
+  int lo = 0;
+  int hi = index->n;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (index->keys[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+int airportIndexUpperBound(const AirportIndex *index, double key) {
+  int lo = 0;
+  int hi = index->n;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (index->keys[mid] <= key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * Finds the (at most two) [start, end) position ranges of the index
+ * that hold keys in [min, max] and returns how many there are.
+ */
+static int findRanges(const AirportIndex *index, double min, double max, int *starts, int *ends) {
+  if (min > max) {
+    if (index->field != INDEX_LONGITUDE) {
+      return 0;
+    }
+    // the range wraps around the antimeridian: [min, 180] and [-180, max]
+    starts[0] = airportIndexLowerBound(index, min);
+    ends[0] = index->n;
+    starts[1] = 0;
+    ends[1] = airportIndexUpperBound(index, max);
+    return 2;
+  }
+
+  starts[0] = airportIndexLowerBound(index, min);
+  ends[0] = airportIndexUpperBound(index, max);
+  return 1;
+}
+
+int airportIndexCount(const AirportIndex *index, double min, double max) {
+  if (index == NULL) {
+    return 0;
+  }
+
+  int starts[2], ends[2];
+  int numRanges = findRanges(index, min, max, starts, ends);
+  int count = 0;
+  for (int r = 0; r < numRanges; r++) {
+    count += ends[r] - starts[r];
+  }
+  return count;
+}
+
+/**
+ * Copies the rows of the keys in [min, max] in index order, which is
+ * all filterByBoundingBox() needs.
+ */
+static int* collectRange(const AirportIndex *index, double min, double max, int *output_size) {
+  int starts[2], ends[2];
+  int numRanges = findRanges(index, min, max, starts, ends);
+  int found = 0;
+  for (int r = 0; r < numRanges; r++) {
+    found += ends[r] - starts[r];
+  }
+
+  if (found == 0) {
+    return NULL;
+  }
+
+  int j = 0;
+  int *result = (int *) malloc(sizeof(int) * found);
+  for (int r = 0; r < numRanges; r++) {
+    memcpy(result + j, index->rows + starts[r], sizeof(int) * (ends[r] - starts[r]));
+    j += ends[r] - starts[r];
+  }
+
+  *output_size = found;
+  return result;
+}
+
+int* airportIndexRange(const AirportIndex *index, double min, double max, int *output_size) {
+  if (index == NULL || output_size == NULL) {
+    return NULL;
+  }
+
+  int *result = collectRange(index, min, max, output_size);
+  if (result != NULL) {
+    qsort(result, *output_size, sizeof(int), cmpRows);
+  }
+  return result;
+}
+
+int* intersectRows(const int *a, int na, const int *b, int nb, int *output_size) {
+  if (a == NULL || b == NULL || output_size == NULL) {
+    return NULL;
+  }
+
+  int *result = (int *) malloc(sizeof(int) * (na < nb ? na : nb));
+  int i = 0, j = 0, found = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      i++;
+    } else if (a[i] > b[j]) {
+      j++;
+    } else {
+      result[found++] = a[i];
+      i++;
+      j++;
+    }
+  }
+
+  if (found == 0) {
+    free(result);
+    return NULL;
+  }
+
+  *output_size = found;
+  return result;
+}
+
+static int inLongitudeRange(double lon, double minLon, double maxLon) {
+  if (minLon > maxLon) {
+    return lon >= minLon || lon <= maxLon;
+  }
+  return lon >= minLon && lon <= maxLon;
+}
+
+Airport* filterByBoundingBox(const Airport *airports,
+                             const AirportIndex *latIndex,
+                             const AirportIndex *lonIndex,
+                             double minLat,
+                             double maxLat,
+                             double minLon,
+                             double maxLon,
+                             int *output_size) {
+  if (airports == NULL || latIndex == NULL || lonIndex == NULL || output_size == NULL) {
+    fprintf(stderr, "ERROR invalid input\n");
+    return NULL;
+  }
+
+  // counting is two binary searches per index, so pick the index
+  // that yields fewer candidates and check the other coordinate directly
+  int latCount = airportIndexCount(latIndex, minLat, maxLat);
+  int lonCount = airportIndexCount(lonIndex, minLon, maxLon);
+  const AirportIndex *index = latCount <= lonCount ? latIndex : lonIndex;
+  int numCandidates = 0;
+  int *candidates = index == latIndex
+      ? collectRange(latIndex, minLat, maxLat, &numCandidates)
+      : collectRange(lonIndex, minLon, maxLon, &numCandidates);
+
+  if (candidates == NULL) {
+    return NULL;
+  }
+
+  int found = 0;
+  Airport *result = (Airport *) malloc(sizeof(Airport) * numCandidates);
+  for (int i = 0; i < numCandidates; i++) {
+    const Airport *a = &airports[candidates[i]];
+    if (a->latitude >= minLat && a->latitude <= maxLat &&
+        inLongitudeRange(a->longitude, minLon, maxLon)) {
+      result[found++] = *a;
+    }
+  }
+  free(candidates);
+
+  if (found == 0) {
+    free(result);
+    return NULL;
+  }
+
+  *output_size = found;
+  return result;
+}
+
+void freeAirportIndex(AirportIndex *index) {
+  if (index != NULL) {
+    free(index->keys);
+    free(index->rows);
+    free(index);
+  }
+}
@@ -0,0 +1,111 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method declarations for sorted Airport indexes
+ */
+
+
+
+#ifndef AIRPORT_INDEX_H
+#define AIRPORT_INDEX_H
+
+#include "airport.h"
+
+/**
+ * The numeric fields an AirportIndex can be built on.
+ */
+typedef enum {
+  INDEX_LATITUDE,
+  INDEX_LONGITUDE,
+  INDEX_ELEVATION
+} AirportIndexField;
+
+/**
+ * A secondary index over one numeric field of an airport table.
+ * keys holds the field values in ascending order and rows holds,
+ * for each key, the position of its airport in the table.
+ */
+typedef struct {
+  AirportIndexField field;
+  double *keys;
+  int *rows;
+  int n;
+} AirportIndex;
+
+/**
+ * A factory function to create a new AirportIndex over the given
+ * field of the n given airports.
+ */
+AirportIndex* createAirportIndex(const Airport *airports, int n, AirportIndexField field);
+
+/**
+ * Returns the position of the first key in the index that is
+ * >= the given key, or n if there is none.
+ */
+int airportIndexLowerBound(const AirportIndex *index, double key);
+
+/**
+ * Returns the position of the first key in the index that is
+ * > the given key, or n if there is none.
+ */
+int airportIndexUpperBound(const AirportIndex *index, double key);
+
+/**
+ * Counts the airports whose key is in [min, max] without
+ * visiting them.  For a longitude index, min > max means the
+ * range crosses the antimeridian.
+ */
+int airportIndexCount(const AirportIndex *index, double min, double max);
+
+/**
+ * Get the rows of the airports whose key is in [min, max], in
+ * ascending row order so they can be intersected with other
+ * results, which costs O(k log k) on top of the O(log n) search.
+ * For a longitude index, min > max means the range crosses the
+ * antimeridian (e.g. 170 to -170).
+ *
+ * @param index the index to search
+ * @param min the smallest key to include
+ * @param max the largest key to include
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated array of rows, or NULL if none match
+ */
+int* airportIndexRange(const AirportIndex *index, double min, double max, int *output_size);
+
+/**
+ * Intersects two ascending arrays of rows.
+ *
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated array of rows, or NULL if none are shared
+ */
+int* intersectRows(const int *a, int na, const int *b, int nb, int *output_size);
+
+/**
+ * Get Airports that are inside the given latitude/longitude box.
+ * Only the more selective of the two indexes is scanned, the other
+ * coordinate is checked directly on the candidates, so the cost is
+ * O(log n) plus the number of candidates.  Airports come back in the
+ * order of the scanned index.  minLon > maxLon means the box crosses
+ * the antimeridian.
+ *
+ * @param airports a pointer to the array of Airport structures that was indexed
+ * @param latIndex a latitude index over airports
+ * @param lonIndex a longitude index over airports
+ * @param output_size int passed by ref, will be output size of resulting array
+ */
+Airport* filterByBoundingBox(const Airport *airports,
+                             const AirportIndex *latIndex,
+                             const AirportIndex *lonIndex,
+                             double minLat,
+                             double maxLat,
+                             double minLon,
+                             double maxLon,
+                             int *output_size);
+
+/**
+ * Frees all the memory used by the given AirportIndex.
+ */
+void freeAirportIndex(AirportIndex *index);
+
+#endif // AIRPORT_INDEX_H
@@ -0,0 +1,113 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains the JNI bindings used by unl.soc.NativeAirportUtils.
+ * Columns are passed as direct ByteBuffers in native byte order, so the
+ * C kernels read and write the Java memory in place.
+ *
+ * Build the shared library with:
+ *
+ *   gcc -O2 -shared -fPIC -pthread -I"$JAVA_HOME/include" -I"$JAVA_HOME/include/linux" \
+ *       -o libairport.so airport.c airportJni.c -lm
+ *
+ * and run Java with -Djava.library.path pointing at its directory.
+ */
+
+
+#include <stdlib.h>
+#include <jni.h>
+#include "airport.h"
+
+/**
+ * Returns the address of the given direct buffer, or NULL (with an
+ * IllegalArgumentException pending) if it is not a direct buffer
+ * holding at least n elements of the given size.
+ */
+static void* bufferAddress(JNIEnv *env, jobject buffer, jint n, jlong elementSize) {
+  void *address = buffer == NULL ? NULL : (*env)->GetDirectBufferAddress(env, buffer);
+  if (address == NULL || (*env)->GetDirectBufferCapacity(env, buffer) < n * elementSize) {
+    jclass exception = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+    (*env)->ThrowNew(env, exception, "expected a direct buffer large enough for n elements");
+    return NULL;
+  }
+  return address;
+}
+
+/**
+ * Returns whether every one of the n row numbers is in [0, n), as the
+ * sort kernels index their keys with them.  Otherwise an
+ * IllegalArgumentException is left pending.
+ */
+static int validRows(JNIEnv *env, const int *rows, jint n) {
+  for (int i = 0; i < n; i++) {
+    if (rows[i] < 0 || rows[i] >= n) {
+      jclass exception = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+      (*env)->ThrowNew(env, exception, "order must hold row numbers in [0, n)");
+      return 0;
+    }
+  }
+  return 1;
+}
+
+JNIEXPORT jint JNICALL Java_unl_soc_NativeAirportUtils_airDistances(JNIEnv *env, jclass cls,
+    jobject latitudes, jobject longitudes, jint n, jdouble originLatitude, jdouble originLongitude,
+    jobject distances) {
+  const double *lats = bufferAddress(env, latitudes, n, sizeof(double));
+  const double *lons = lats == NULL ? NULL : bufferAddress(env, longitudes, n, sizeof(double));
+  double *out = lons == NULL ? NULL : bufferAddress(env, distances, n, sizeof(double));
+  if (out == NULL) {
+    return -1;
+  }
+  return batchAirDistance(lats, lons, n, originLatitude, originLongitude, out);
+}
+
+JNIEXPORT jint JNICALL Java_unl_soc_NativeAirportUtils_sortByAirDistance(JNIEnv *env, jclass cls,
+    jobject latitudes, jobject longitudes, jint n, jdouble originLatitude, jdouble originLongitude,
+    jobject order) {
+  const double *lats = bufferAddress(env, latitudes, n, sizeof(double));
+  const double *lons = lats == NULL ? NULL : bufferAddress(env, longitudes, n, sizeof(double));
+  int *out = lons == NULL ? NULL : bufferAddress(env, order, n, sizeof(int));
+  if (out == NULL) {
+    return -1;
+  }
+  return sortByAirDistance(lats, lons, n, originLatitude, originLongitude, out);
+}
+
+JNIEXPORT jint JNICALL Java_unl_soc_NativeAirportUtils_filterByRange(JNIEnv *env, jclass cls,
+    jobject values, jint n, jdouble min, jdouble max, jobject rows) {
+  const double *in = bufferAddress(env, values, n, sizeof(double));
+  int *out = in == NULL ? NULL : bufferAddress(env, rows, n, sizeof(int));
+  if (out == NULL) {
+    return -1;
+  }
+  return filterByRange(in, n, min, max, out);
+}
+
+JNIEXPORT jint JNICALL Java_unl_soc_NativeAirportUtils_sortByDoubleKey(JNIEnv *env, jclass cls,
+    jobject keys, jint n, jboolean descending, jobject order) {
+  const double *in = bufferAddress(env, keys, n, sizeof(double));
+  int *out = in == NULL ? NULL : bufferAddress(env, order, n, sizeof(int));
+  if (out == NULL || !validRows(env, out, n)) {
+    return -1;
+  }
+  return sortByDoubleKey(in, n, descending, out);
+}
+
+JNIEXPORT jint JNICALL Java_unl_soc_NativeAirportUtils_sortByStringKey(JNIEnv *env, jclass cls,
+    jobject chars, jint numChars, jobject offsets, jint n, jboolean descending, jobject order) {
+  const unsigned short *in = bufferAddress(env, chars, numChars, sizeof(unsigned short));
+  const int *bounds = in == NULL ? NULL : bufferAddress(env, offsets, n + 1, sizeof(int));
+  int *out = bounds == NULL ? NULL : bufferAddress(env, order, n, sizeof(int));
+  if (out == NULL || !validRows(env, out, n)) {
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    if (bounds[i] < 0 || bounds[i] > bounds[i + 1] || bounds[i + 1] > numChars) {
+      jclass exception = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+      (*env)->ThrowNew(env, exception, "offsets must be ascending and within chars");
+      return -1;
+    }
+  }
+  return sortByStringKey(in, bounds, n, descending, out);
+}
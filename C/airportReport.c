@@ -10,6 +10,10 @@
 #include <string.h>
 #include <stdlib.h>
 #include "airport.h"
+#include "stringStore.h"
+#include "airportIndex.h"
+#include "textIndex.h"
+#include "airportShard.h"
 
 int main() {
     // testing createAirport
@@ -50,6 +54,152 @@ int main() {
 
     generateReports(airports, n);
 
+    printf("\nAirports Grouped By Country: \n");
+    printf("==============================\n");
+    int numGroups = 0;
+    AirportGroup *groups = groupAirports(airports, n, GROUP_BY_COUNTRY, &numGroups);
+    printAirportGroups(groups, numGroups);
+    free(groups);
+
+    printf("\nCompact Airport Names: \n");
+    printf("==============================\n");
+    AirportStrings *strings = createAirportStrings(airports, n);
+    char *name = (char *) malloc(sizeof(char) * (strings->names->maxLength + 1));
+    for (int i = 0; i < n; i++) {
+        stringStoreGet(strings->names, strings->nameIds[i], name);
+        printf("%-8d %s\n", strings->nameIds[i], name);
+    }
+    printf("%ld bytes\n", stringStoreMemoryUsage(strings->names));
+    printf("Id of \"JFK\": %d\n", stringStoreFind(strings->names, "JFK"));
+    printf("Id of \"Missing Airport\": %d\n", stringStoreFind(strings->names, "Missing Airport"));
+    free(name);
+
+    printf("\nAirports From Compact Strings: \n");
+    printf("==============================\n");
+    printAirportsFromStrings(strings, airports, n);
+    freeAirportStrings(strings);
+
+    printf("\nAirports After Releasing Their Strings: \n");
+    printf("==============================\n");
+    // airports shares its strings with a1..a10, so release a deep copy
+    Airport *owned = (Airport *) malloc(sizeof(Airport) * n);
+    for (int i = 0; i < n; i++) {
+        initAirport(&owned[i], airports[i].gpsId, airports[i].type, airports[i].name, airports[i].latitude,
+                    airports[i].longitude, airports[i].elevationFeet, airports[i].city, airports[i].countryAbbrv);
+    }
+    AirportStrings *ownedStrings = createAirportStrings(owned, n);
+    releaseAirportStringFields(owned, n);
+    printAirportsFromStrings(ownedStrings, owned, n);
+    freeAirportStrings(ownedStrings);
+    for (int i = 0; i < n; i++) {
+        free(owned[i].type);
+        free(owned[i].countryAbbrv);
+    }
+    free(owned);
+
+    printf("\nAirports Between Latitudes 30 and 45: \n");
+    printf("==============================\n");
+    AirportIndex *latIndex = createAirportIndex(airports, n, INDEX_LATITUDE);
+    AirportIndex *lonIndex = createAirportIndex(airports, n, INDEX_LONGITUDE);
+    int boxFound = 0;
+    Airport *boxAirports = filterByBoundingBox(airports, latIndex, lonIndex, 30, 45, -180, 180, &boxFound);
+    if (boxAirports == NULL) {
+        printf("No airports found!\n");
+    } else {
+        printAirports(boxAirports, boxFound);
+        free(boxAirports);
+    }
+
+    printf("\nAirports From Longitude 120 East to 60 West: \n");
+    printf("==============================\n");
+    boxAirports = filterByBoundingBox(airports, latIndex, lonIndex, -90, 90, 120, -60, &boxFound);
+    if (boxAirports == NULL) {
+        printf("No airports found!\n");
+    } else {
+        printAirports(boxAirports, boxFound);
+        free(boxAirports);
+    }
+    freeAirportIndex(latIndex);
+    freeAirportIndex(lonIndex);
+
+    AirportTextIndex *textIndex = createAirportTextIndex(airports, n);
+    const char *prefixes[] = {"Santorini", "cheon", "KR"};
+    for (int q = 0; q < 3; q++) {
+        printf("\nAirports Starting With \"%s\": \n", prefixes[q]);
+        printf("==============================\n");
+        int textFound = 0;
+        int *rows = searchByPrefix(textIndex, prefixes[q], &textFound);
+        if (rows == NULL) {
+            printf("No airports found!\n");
+        } else {
+            for (int i = 0; i < textFound; i++) {
+                printAirports(&airports[rows[i]], 1);
+            }
+            free(rows);
+        }
+    }
+
+    const char *substrings[] = {"heliport", "AIRP", "o", "xyz"};
+    for (int q = 0; q < 4; q++) {
+        printf("\nAirports Containing \"%s\": \n", substrings[q]);
+        printf("==============================\n");
+        int textFound = 0;
+        int *rows = searchBySubstring(textIndex, substrings[q], &textFound);
+        if (rows == NULL) {
+            printf("No airports found!\n");
+        } else {
+            for (int i = 0; i < textFound; i++) {
+                printAirports(&airports[rows[i]], 1);
+            }
+            free(rows);
+        }
+    }
+    freeAirportTextIndex(textIndex);
+
+    ShardServer *server = createShardServer(airports, n, 3);
+    if (server != NULL) {
+        Airport shardAirport;
+        int shardFound = 0;
+
+        printf("\n3 Closest Airports to Lincoln (sharded): \n");
+        printf("==============================\n");
+        ShardHit *hits = shardNearest(server, 40.846176, -96.75471, 3, &shardFound);
+        for (int i = 0; hits != NULL && i < shardFound; i++) {
+            shardHitToAirport(server, &hits[i], &shardAirport);
+            printAirports(&shardAirport, 1);
+        }
+        free(hits);
+
+        printf("\nAirports Within 1000 km of Seoul (sharded): \n");
+        printf("==============================\n");
+        hits = shardWithinRadius(server, 37.57, 126.98, 1000, &shardFound);
+        for (int i = 0; hits != NULL && i < shardFound; i++) {
+            shardHitToAirport(server, &hits[i], &shardAirport);
+            printAirports(&shardAirport, 1);
+        }
+        free(hits);
+
+        printf("\nHeliports (sharded): \n");
+        printf("==============================\n");
+        hits = shardFilterByType(server, "heliport", &shardFound);
+        for (int i = 0; hits != NULL && i < shardFound; i++) {
+            shardHitToAirport(server, &hits[i], &shardAirport);
+            printAirports(&shardAirport, 1);
+        }
+        free(hits);
+
+        printf("\n3 Highest Airports (sharded): \n");
+        printf("==============================\n");
+        hits = shardTopByElevation(server, 3, &shardFound);
+        for (int i = 0; hits != NULL && i < shardFound; i++) {
+            shardHitToAirport(server, &hits[i], &shardAirport);
+            printAirports(&shardAirport, 1);
+        }
+        free(hits);
+
+        freeShardServer(server);
+    }
+
     freeAirport(a1);
     freeAirport(a2);
     freeAirport(a3);
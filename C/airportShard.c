@@ -0,0 +1,655 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method definitions for the sharded Airport query server.
+ *
+ * The coordinator and every worker share one mapping.  Each shard has a
+ * request ring (written by the coordinator, read by its worker) and a
+ * reply ring (written by its worker, read by the coordinator), so every
+ * ring has exactly one producer and one consumer and needs no locks.
+ * Workers also watch their parent, so they exit rather than spin on the
+ * rings forever if the coordinator dies without calling freeShardServer(),
+ * and the coordinator watches its workers, so a query fails rather than
+ * waits forever on a shard whose worker died.
+ * Link with -lrt on systems where shm_open lives there.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include "airportShard.h"
+
+/**
+ * The size of a geographic cell in degrees.  Neighbouring cells go to
+ * different shards so dense regions are spread over all workers.
+ */
+#define SHARD_CELL_DEGREES 10
+
+_Static_assert(sizeof(ShardInfo) % 64 == 0, "ShardInfo must fill whole cache lines");
+
+static int shardOf(double latitude, double longitude, int numShards) {
+  int latCell = (int)((latitude + 90) / SHARD_CELL_DEGREES);
+  int lonCell = (int)((longitude + 180) / SHARD_CELL_DEGREES);
+  int lonCells = 360 / SHARD_CELL_DEGREES;
+  if (lonCell >= lonCells) {
+    lonCell = lonCells - 1;
+  }
+  return (latCell * lonCells + lonCell) % numShards;
+}
+
+static int ringPush(ShardRing *ring, const ShardMessage *message) {
+  unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  if (tail - head == SHARD_RING_CAPACITY) {
+    return 0;
+  }
+  ring->slots[tail & (SHARD_RING_CAPACITY - 1)] = *message;
+  atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+  return 1;
+}
+
+static int ringPop(ShardRing *ring, ShardMessage *message) {
+  unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  if (head == tail) {
+    return 0;
+  }
+  *message = ring->slots[head & (SHARD_RING_CAPACITY - 1)];
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+  return 1;
+}
+
+/**
+ * Waits a little longer each time it is called in a row: first by
+ * spinning, then by yielding, then by sleeping, so idle processes
+ * do not hold on to a core.
+ */
+static void backoff(int *spins) {
+  (*spins)++;
+  if (*spins < 64) {
+    return;
+  } else if (*spins < 1024) {
+    sched_yield();
+  } else {
+    struct timespec pause = {0, 50000};
+    nanosleep(&pause, NULL);
+  }
+}
+
+/**
+ * Returns whether the worker waiting has been orphaned.  Only checked
+ * once backoff() has started sleeping, so busy rings pay nothing for it.
+ */
+static int parentGone(pid_t parent, int spins) {
+  return spins >= 1024 && getppid() != parent;
+}
+
+/**
+ * Pushes the message, waiting for room.
+ *
+ * @return 1 once pushed, or 0 if the given parent exited first
+ */
+static int ringPushWait(ShardRing *ring, const ShardMessage *message, pid_t parent) {
+  int spins = 0;
+  while (!ringPush(ring, message)) {
+    if (parentGone(parent, spins)) {
+      return 0;
+    }
+    backoff(&spins);
+  }
+  return 1;
+}
+
+/**
+ * Pops a message, waiting for one.
+ *
+ * @return 1 once popped, or 0 if the given parent exited first
+ */
+static int ringPopWait(ShardRing *ring, ShardMessage *message, pid_t parent) {
+  int spins = 0;
+  while (!ringPop(ring, message)) {
+    if (parentGone(parent, spins)) {
+      return 0;
+    }
+    backoff(&spins);
+  }
+  return 1;
+}
+
+static int cmpShardHit(const void* a, const void* b) {
+  const ShardHit* _a = (const ShardHit*)a;
+  const ShardHit* _b = (const ShardHit*)b;
+
+  if (_a->score > _b->score) return 1;
+  else if (_a->score < _b->score) return -1;
+  else return _a->row - _b->row;
+}
+
+static void siftDown(ShardHit *heap, int k, int i) {
+  for (;;) {
+    int largest = i;
+    int left = 2 * i + 1;
+    int right = left + 1;
+    if (left < k && cmpShardHit(&heap[left], &heap[largest]) > 0) largest = left;
+    if (right < k && cmpShardHit(&heap[right], &heap[largest]) > 0) largest = right;
+    if (largest == i) {
+      return;
+    }
+    ShardHit temp = heap[i];
+    heap[i] = heap[largest];
+    heap[largest] = temp;
+    i = largest;
+  }
+}
+
+/**
+ * Moves the k lowest scoring of the n hits to the front, in no
+ * particular order, using a max-heap of the best k seen so far.
+ */
+static int selectBest(ShardHit *hits, int n, int k) {
+  for (int i = k / 2 - 1; i >= 0; i--) {
+    siftDown(hits, k, i);
+  }
+  for (int i = k; i < n; i++) {
+    if (cmpShardHit(&hits[i], &hits[0]) < 0) {
+      hits[0] = hits[i];
+      siftDown(hits, k, 0);
+    }
+  }
+  return k;
+}
+
+/**
+ * Answers the query over the given shard, writing the hits into hits
+ * and returning how many there are.
+ */
+static int answerQuery(const ShardServer *server, const ShardInfo *shard, const ShardQuery *query,
+                       ShardHit *hits, double *distances) {
+  int found = 0;
+  int n = shard->numAirports;
+
+  switch (query->type) {
+    case SHARD_QUERY_NEAREST:
+    case SHARD_QUERY_RADIUS:
+      batchAirDistance(server->latitudes + shard->offset, server->longitudes + shard->offset, n,
+                       query->latitude, query->longitude, distances);
+      for (int i = 0; i < n; i++) {
+        if (distances[i] < 0) {
+          continue;
+        }
+        if (query->type == SHARD_QUERY_RADIUS && distances[i] > query->radiusKm) {
+          continue;
+        }
+        hits[found].row = shard->offset + i;
+        hits[found].score = distances[i];
+        found++;
+      }
+      break;
+    case SHARD_QUERY_TYPE:
+      for (int i = 0; i < n; i++) {
+        // types are interned, so equal types share one offset
+        if (server->airports[shard->offset + i].type == query->typeOffset) {
+          hits[found].row = shard->offset + i;
+          hits[found].score = 0;
+          found++;
+        }
+      }
+      break;
+    case SHARD_QUERY_TOP_ELEVATION:
+      for (int i = 0; i < n; i++) {
+        hits[found].row = shard->offset + i;
+        hits[found].score = -server->airports[shard->offset + i].elevationFeet;
+        found++;
+      }
+      break;
+    default:
+      break;
+  }
+
+  // only the k best hits are needed, so select them before sorting
+  if ((query->type == SHARD_QUERY_NEAREST || query->type == SHARD_QUERY_TOP_ELEVATION) && found > query->k) {
+    found = selectBest(hits, found, query->k);
+  }
+  if (query->type != SHARD_QUERY_TYPE) {
+    qsort(hits, found, sizeof(ShardHit), cmpShardHit);
+  }
+  return found;
+}
+
+static void runWorker(ShardServer *server, int shardIndex, pid_t parent) {
+  ShardInfo *shard = &server->shards[shardIndex];
+  int size = shard->numAirports > 0 ? shard->numAirports : 1;
+  ShardHit *hits = (ShardHit *) malloc(sizeof(ShardHit) * size);
+  double *distances = (double *) malloc(sizeof(double) * size);
+  ShardMessage message;
+
+  for (;;) {
+    if (!ringPopWait(&shard->requests, &message, parent) || message.query.type == SHARD_QUERY_SHUTDOWN) {
+      break;
+    }
+
+    int found = answerQuery(server, shard, &message.query, hits, distances);
+
+    // send the hits back in batches, the last one is marked done
+    int sent = 0;
+    int alive = 1;
+    do {
+      int count = found - sent < SHARD_BATCH_SIZE ? found - sent : SHARD_BATCH_SIZE;
+      message.reply.count = count;
+      memcpy(message.reply.hits, hits + sent, sizeof(ShardHit) * count);
+      sent += count;
+      message.reply.done = sent == found;
+      alive = ringPushWait(&shard->replies, &message, parent);
+    } while (alive && sent < found);
+    if (!alive) {
+      break;
+    }
+  }
+
+  free(hits);
+  free(distances);
+}
+
+/**
+ * Copies the string to the end of the server's string arena and
+ * returns its offset there.  NULL is stored as "".
+ */
+static size_t appendString(ShardServer *server, size_t *used, const char *str) {
+  size_t offset = *used;
+  size_t length = str != NULL ? strlen(str) : 0;
+  memcpy(server->strings + offset, str != NULL ? str : "", length);
+  server->strings[offset + length] = '\0';
+  *used += length + 1;
+  return offset;
+}
+
+static size_t stringBytes(const char *str) {
+  return (str != NULL ? strlen(str) : 0) + 1;
+}
+
+typedef struct {
+  const char *type;
+  int index;
+} TypeEntry;
+
+static int cmpTypeEntry(const void* a, const void* b) {
+  const TypeEntry* _a = (const TypeEntry*)a;
+  const TypeEntry* _b = (const TypeEntry*)b;
+
+  return strcmp(_a->type, _b->type);
+}
+
+ShardServer* createShardServer(const Airport *airports, int n, int numShards) {
+  if (airports == NULL || n < 0 || numShards <= 0) {
+    fprintf(stderr, "ERROR invalid input\n");
+    return NULL;
+  }
+
+  ShardServer *server = (ShardServer *) malloc(sizeof(ShardServer));
+  server->numShards = numShards;
+  server->numAirports = n;
+
+  // types repeat a lot, so each distinct type is stored once and
+  // compared by offset; the other strings are stored per airport
+  TypeEntry *types = (TypeEntry *) malloc(sizeof(TypeEntry) * (n > 0 ? n : 1));
+  for (int i = 0; i < n; i++) {
+    types[i].type = airports[i].type != NULL ? airports[i].type : "";
+    types[i].index = i;
+  }
+  qsort(types, n, sizeof(TypeEntry), cmpTypeEntry);
+
+  size_t numStringBytes = 0;
+  for (int i = 0; i < n; i++) {
+    if (i == 0 || strcmp(types[i].type, types[i - 1].type) != 0) {
+      numStringBytes += stringBytes(types[i].type);
+    }
+    numStringBytes += stringBytes(airports[i].gpsId) + stringBytes(airports[i].name)
+                      + stringBytes(airports[i].city) + stringBytes(airports[i].countryAbbrv);
+  }
+  server->regionSize = sizeof(ShardInfo) * numShards + (sizeof(ShardAirport) + 2 * sizeof(double)) * n
+                       + numStringBytes;
+
+  char shmName[64];
+  snprintf(shmName, sizeof(shmName), "/airport-shards-%d", (int) getpid());
+  int fd = shm_open(shmName, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    perror("ERROR shm_open");
+    free(types);
+    free(server);
+    return NULL;
+  }
+  if (ftruncate(fd, server->regionSize) != 0) {
+    perror("ERROR ftruncate");
+    close(fd);
+    shm_unlink(shmName);
+    free(types);
+    free(server);
+    return NULL;
+  }
+  server->region = mmap(NULL, server->regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  // the mapping outlives the name, and no stale segment is left behind if we crash
+  shm_unlink(shmName);
+  if (server->region == MAP_FAILED) {
+    perror("ERROR mmap");
+    free(types);
+    free(server);
+    return NULL;
+  }
+
+  server->shards = (ShardInfo *) server->region;
+  server->airports = (ShardAirport *) (server->shards + numShards);
+  server->latitudes = (double *) (server->airports + n);
+  server->longitudes = server->latitudes + n;
+  server->strings = (char *) (server->longitudes + n);
+
+  // count the airports of each shard to find where each shard starts
+  int *shardOfAirport = (int *) malloc(sizeof(int) * (n > 0 ? n : 1));
+  for (int s = 0; s < numShards; s++) {
+    atomic_init(&server->shards[s].requests.head, 0);
+    atomic_init(&server->shards[s].requests.tail, 0);
+    atomic_init(&server->shards[s].replies.head, 0);
+    atomic_init(&server->shards[s].replies.tail, 0);
+    server->shards[s].numAirports = 0;
+  }
+  for (int i = 0; i < n; i++) {
+    shardOfAirport[i] = shardOf(airports[i].latitude, airports[i].longitude, numShards);
+    server->shards[shardOfAirport[i]].numAirports++;
+  }
+  int offset = 0;
+  for (int s = 0; s < numShards; s++) {
+    server->shards[s].offset = offset;
+    offset += server->shards[s].numAirports;
+    server->shards[s].numAirports = 0;
+  }
+  int *rowOfAirport = (int *) malloc(sizeof(int) * (n > 0 ? n : 1));
+  size_t used = 0;
+  for (int i = 0; i < n; i++) {
+    ShardInfo *shard = &server->shards[shardOfAirport[i]];
+    int row = shard->offset + shard->numAirports++;
+    ShardAirport *a = &server->airports[row];
+    rowOfAirport[i] = row;
+    a->gpsId = appendString(server, &used, airports[i].gpsId);
+    a->name = appendString(server, &used, airports[i].name);
+    a->city = appendString(server, &used, airports[i].city);
+    a->countryAbbrv = appendString(server, &used, airports[i].countryAbbrv);
+    a->latitude = airports[i].latitude;
+    a->longitude = airports[i].longitude;
+    a->elevationFeet = airports[i].elevationFeet;
+    server->latitudes[row] = airports[i].latitude;
+    server->longitudes[row] = airports[i].longitude;
+  }
+  free(shardOfAirport);
+
+  // intern the types, in sorted order so the coordinator can search them
+  server->typeOffsets = (size_t *) malloc(sizeof(size_t) * (n > 0 ? n : 1));
+  server->numTypes = 0;
+  for (int i = 0; i < n; i++) {
+    if (i == 0 || strcmp(types[i].type, types[i - 1].type) != 0) {
+      server->typeOffsets[server->numTypes++] = appendString(server, &used, types[i].type);
+    }
+    server->airports[rowOfAirport[types[i].index]].type = server->typeOffsets[server->numTypes - 1];
+  }
+  free(types);
+  free(rowOfAirport);
+
+  server->workers = (pid_t *) malloc(sizeof(pid_t) * numShards);
+  pid_t parent = getpid();
+  for (int s = 0; s < numShards; s++) {
+    pid_t pid = fork();
+    if (pid == 0) {
+#ifdef __linux__
+      // have the kernel stop us if the coordinator dies
+      prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+      // the coordinator may have died before the line above took effect
+      if (getppid() != parent) {
+        _exit(1);
+      }
+      runWorker(server, s, parent);
+      _exit(0);
+    } else if (pid < 0) {
+      perror("ERROR fork");
+      server->numShards = s;
+      freeShardServer(server);
+      return NULL;
+    }
+    server->workers[s] = pid;
+  }
+
+  return server;
+}
+
+/**
+ * Returns whether the worker of shard s has exited, reaping it and
+ * marking it with a pid of 0 if so.
+ */
+static int workerGone(ShardServer *server, int s) {
+  pid_t pid = server->workers[s];
+  if (pid == 0) {
+    return 1;
+  }
+  pid_t result = waitpid(pid, NULL, WNOHANG);
+  // ECHILD means someone else reaps our children (SIGCHLD ignored),
+  // so fall back to asking whether the process is still there
+  if (result == pid || (result < 0 && (errno != ECHILD || (kill(pid, 0) < 0 && errno == ESRCH)))) {
+    server->workers[s] = 0;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Pushes the message onto the request ring of shard s, waiting for
+ * room while its worker is alive.
+ *
+ * @return 1 once pushed, or 0 if the worker exited first
+ */
+static int pushRequest(ShardServer *server, int s, const ShardMessage *message) {
+  int spins = 0;
+  while (!ringPush(&server->shards[s].requests, message)) {
+    if (spins >= 1024 && workerGone(server, s)) {
+      return 0;
+    }
+    backoff(&spins);
+  }
+  return 1;
+}
+
+/**
+ * Sends the query to every shard, collects all of their hits and
+ * merges them by score.  If k > 0 only the k best hits are kept.
+ * Returns NULL if a worker has died, its shard can no longer answer.
+ */
+static ShardHit* scatterGather(ShardServer *server, const ShardQuery *query, int k, int *output_size) {
+  if (server->numShards <= 0) {
+    return NULL;
+  }
+
+  for (int s = 0; s < server->numShards; s++) {
+    if (server->workers[s] == 0) {
+      fprintf(stderr, "ERROR shard %d has no worker\n", s);
+      return NULL;
+    }
+  }
+
+  int capacity = 64;
+  int found = 0;
+  int failed = 0;
+  ShardHit *hits = (ShardHit *) malloc(sizeof(ShardHit) * capacity);
+  char *done = (char *) calloc(server->numShards, sizeof(char));
+  int remaining = server->numShards;
+  int spins = 0;
+
+  ShardMessage message;
+  message.query = *query;
+  for (int s = 0; s < server->numShards; s++) {
+    if (!pushRequest(server, s, &message)) {
+      fprintf(stderr, "ERROR shard %d worker exited\n", s);
+      failed = 1;
+      done[s] = 1;
+      remaining--;
+    }
+  }
+
+  // poll every shard in turn, so a worker blocked on a full reply ring
+  // is drained while we wait on the others
+  while (remaining > 0) {
+    int progress = 0;
+    for (int s = 0; s < server->numShards; s++) {
+      if (done[s] || !ringPop(&server->shards[s].replies, &message)) {
+        continue;
+      }
+      progress = 1;
+      while (found + message.reply.count > capacity) {
+        capacity *= 2;
+        hits = (ShardHit *) realloc(hits, sizeof(ShardHit) * capacity);
+      }
+      memcpy(hits + found, message.reply.hits, sizeof(ShardHit) * message.reply.count);
+      found += message.reply.count;
+      if (message.reply.done) {
+        done[s] = 1;
+        remaining--;
+      }
+    }
+    if (progress) {
+      spins = 0;
+      continue;
+    }
+    // still drain the live shards, so their replies to this query are
+    // not read as replies to the next one
+    for (int s = 0; spins >= 1024 && s < server->numShards; s++) {
+      if (!done[s] && workerGone(server, s)) {
+        fprintf(stderr, "ERROR shard %d worker exited\n", s);
+        failed = 1;
+        done[s] = 1;
+        remaining--;
+      }
+    }
+    backoff(&spins);
+  }
+  free(done);
+
+  if (failed) {
+    free(hits);
+    return NULL;
+  }
+
+  qsort(hits, found, sizeof(ShardHit), cmpShardHit);
+  if (k > 0 && found > k) {
+    found = k;
+  }
+
+  if (found == 0) {
+    free(hits);
+    return NULL;
+  }
+
+  *output_size = found;
+  return hits;
+}
+
+ShardHit* shardNearest(ShardServer *server, double latitude, double longitude, int k, int *output_size) {
+  if (server == NULL || k <= 0 || output_size == NULL) {
+    return NULL;
+  }
+
+  if (latitude < -90 || latitude > 90 || longitude < -180 || longitude > 180) {
+    fprintf(stderr, "ERROR invalid input (latitude/longitude)\n");
+    return NULL;
+  }
+
+  ShardQuery query = {SHARD_QUERY_NEAREST, latitude, longitude, 0, k, 0};
+  return scatterGather(server, &query, k, output_size);
+}
+
+ShardHit* shardWithinRadius(ShardServer *server, double latitude, double longitude, double radiusKm, int *output_size) {
+  if (server == NULL || output_size == NULL) {
+    return NULL;
+  }
+
+  if (latitude < -90 || latitude > 90 || longitude < -180 || longitude > 180) {
+    fprintf(stderr, "ERROR invalid input (latitude/longitude)\n");
+    return NULL;
+  }
+
+  ShardQuery query = {SHARD_QUERY_RADIUS, latitude, longitude, radiusKm, 0, 0};
+  return scatterGather(server, &query, 0, output_size);
+}
+
+ShardHit* shardFilterByType(ShardServer *server, const char *type, int *output_size) {
+  if (server == NULL || type == NULL || output_size == NULL) {
+    return NULL;
+  }
+
+  // find the interned type, no airport has a type that is not there
+  int low = 0;
+  int high = server->numTypes - 1;
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    int cmp = strcmp(server->strings + server->typeOffsets[mid], type);
+    if (cmp == 0) {
+      ShardQuery query = {SHARD_QUERY_TYPE, 0, 0, 0, 0, server->typeOffsets[mid]};
+      return scatterGather(server, &query, 0, output_size);
+    } else if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return NULL;
+}
+
+ShardHit* shardTopByElevation(ShardServer *server, int k, int *output_size) {
+  if (server == NULL || k <= 0 || output_size == NULL) {
+    return NULL;
+  }
+
+  ShardQuery query = {SHARD_QUERY_TOP_ELEVATION, 0, 0, 0, k, 0};
+  return scatterGather(server, &query, k, output_size);
+}
+
+void shardHitToAirport(const ShardServer *server, const ShardHit *hit, Airport *airport) {
+  ShardAirport *a = &server->airports[hit->row];
+  airport->gpsId = server->strings + a->gpsId;
+  airport->type = server->strings + a->type;
+  airport->name = server->strings + a->name;
+  airport->latitude = a->latitude;
+  airport->longitude = a->longitude;
+  airport->elevationFeet = a->elevationFeet;
+  airport->city = server->strings + a->city;
+  airport->countryAbbrv = server->strings + a->countryAbbrv;
+}
+
+void freeShardServer(ShardServer *server) {
+  if (server != NULL) {
+    ShardMessage message;
+    message.query.type = SHARD_QUERY_SHUTDOWN;
+    for (int s = 0; s < server->numShards; s++) {
+      pushRequest(server, s, &message);
+    }
+    for (int s = 0; s < server->numShards; s++) {
+      if (server->workers[s] != 0) {
+        waitpid(server->workers[s], NULL, 0);
+      }
+    }
+    munmap(server->region, server->regionSize);
+    free(server->typeOffsets);
+    free(server->workers);
+    free(server);
+  }
+}
@@ -0,0 +1,192 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method declarations for the sharded Airport query server
+ */
+
+
+
+#ifndef AIRPORT_SHARD_H
+#define AIRPORT_SHARD_H
+
+#include <sys/types.h>
+#include <stdatomic.h>
+#include "airport.h"
+
+/**
+ * The number of messages each ring buffer holds, must be a power of 2.
+ */
+#define SHARD_RING_CAPACITY 64
+
+/**
+ * The most hits a worker sends back in one reply message.
+ */
+#define SHARD_BATCH_SIZE 32
+
+/**
+ * An Airport laid out without pointers so it can live in shared
+ * memory.  Its strings are stored in full in the shared string
+ * arena, and each field holds the offset of one there.
+ */
+typedef struct {
+  size_t gpsId;
+  size_t type;
+  size_t name;
+  size_t city;
+  size_t countryAbbrv;
+  double latitude;
+  double longitude;
+  int elevationFeet;
+} ShardAirport;
+
+/**
+ * One result of a sharded query: the row of the airport in the
+ * shared table and the value it was ranked by (a distance in
+ * kilometers, or the negated elevation for elevation queries).
+ */
+typedef struct {
+  int row;
+  double score;
+} ShardHit;
+
+typedef enum {
+  SHARD_QUERY_NEAREST,
+  SHARD_QUERY_RADIUS,
+  SHARD_QUERY_TYPE,
+  SHARD_QUERY_TOP_ELEVATION,
+  SHARD_QUERY_SHUTDOWN
+} ShardQueryType;
+
+typedef struct {
+  ShardQueryType type;
+  double latitude;
+  double longitude;
+  double radiusKm;
+  int k;
+  size_t typeOffset;
+} ShardQuery;
+
+typedef struct {
+  int done;
+  int count;
+  ShardHit hits[SHARD_BATCH_SIZE];
+} ShardReply;
+
+typedef union {
+  ShardQuery query;
+  ShardReply reply;
+} ShardMessage;
+
+/**
+ * A lock-free single producer, single consumer ring of messages.
+ * head and tail only ever grow, and are kept on separate cache lines
+ * so the producer and consumer do not contend on them.  The ring is
+ * 64 byte aligned, so neither shares a line with whatever precedes
+ * the ring in memory.
+ */
+typedef struct {
+  _Alignas(64) _Atomic unsigned int head;
+  char headPadding[64 - sizeof(unsigned int)];
+  _Alignas(64) _Atomic unsigned int tail;
+  char tailPadding[64 - sizeof(unsigned int)];
+  ShardMessage slots[SHARD_RING_CAPACITY];
+} ShardRing;
+
+/**
+ * The shared state of one shard: its two rings and the range of
+ * the shared table it owns.  Its rings make it 64 byte aligned, so
+ * its size is a multiple of 64 and every shard in the array starts
+ * on a fresh cache line.
+ */
+typedef struct {
+  ShardRing requests;
+  ShardRing replies;
+  int offset;
+  int numAirports;
+} ShardInfo;
+
+/**
+ * A coordinator for a table of airports split by geographic cell
+ * into shards, each served by its own worker process.  The table,
+ * its latitude/longitude columns, its string arena and the rings
+ * all live in one POSIX shared memory mapping.  typeOffsets holds
+ * the offset of each distinct type in the arena, sorted by type.
+ *
+ * Each ring has a single producer and a single consumer, so a
+ * ShardServer is not thread safe: all of the shard query functions
+ * and freeShardServer() must be called from one coordinator thread
+ * (or be serialized by the caller).  On Linux that thread should
+ * also outlive the server, as workers are sent SIGTERM when the
+ * thread that forked them exits.
+ */
+typedef struct {
+  int numShards;
+  int numAirports;
+  void *region;
+  size_t regionSize;
+  ShardInfo *shards;
+  ShardAirport *airports;
+  double *latitudes;
+  double *longitudes;
+  char *strings;
+  size_t *typeOffsets;
+  int numTypes;
+  pid_t *workers;
+} ShardServer;
+
+/**
+ * A factory function to create a new ShardServer over the n given
+ * airports, with one worker process for each of numShards shards.
+ */
+ShardServer* createShardServer(const Airport *airports, int n, int numShards);
+
+/**
+ * Get the k airports closest to the given point, closest first.
+ * Like every shard query, it returns NULL with an error once a
+ * worker process has died, as its shard can no longer be searched.
+ *
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated array of hits, or NULL if there are none
+ */
+ShardHit* shardNearest(ShardServer *server, double latitude, double longitude, int k, int *output_size);
+
+/**
+ * Get the airports within radiusKm kilometers of the given point,
+ * closest first.
+ *
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated array of hits, or NULL if there are none
+ */
+ShardHit* shardWithinRadius(ShardServer *server, double latitude, double longitude, double radiusKm, int *output_size);
+
+/**
+ * Get the airports of the given type.
+ *
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated array of hits, or NULL if there are none
+ */
+ShardHit* shardFilterByType(ShardServer *server, const char *type, int *output_size);
+
+/**
+ * Get the k highest airports, highest first.
+ *
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated array of hits, or NULL if there are none
+ */
+ShardHit* shardTopByElevation(ShardServer *server, int k, int *output_size);
+
+/**
+ * Fills in an Airport that refers to the shared copy of the given
+ * hit's airport, so it can be used with the other Airport functions.
+ * It must not be passed to freeAirport().
+ */
+void shardHitToAirport(const ShardServer *server, const ShardHit *hit, Airport *airport);
+
+/**
+ * Stops the worker processes and frees all the memory used by the
+ * given ShardServer.
+ */
+void freeShardServer(ShardServer *server);
+
+#endif // AIRPORT_SHARD_H
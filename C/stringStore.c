@@ -0,0 +1,322 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method definitions for the compact string store
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "stringStore.h"
+
+static int cmpStrings(const void* a, const void* b) {
+  return strcmp(*(const char **)a, *(const char **)b);
+}
+
+static void writeLength(StringStore *store, int *capacity, int value) {
+  // a length needs at most 5 bytes
+  if (store->dataSize + 5 > *capacity) {
+    *capacity *= 2;
+    store->data = (unsigned char *) realloc(store->data, *capacity);
+  }
+  do {
+    unsigned char byte = value & 0x7F;
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80;
+    }
+    store->data[store->dataSize++] = byte;
+  } while (value != 0);
+}
+
+static int readLength(const unsigned char **p) {
+  int value = 0;
+  int shift = 0;
+  unsigned char byte;
+  do {
+    byte = **p;
+    (*p)++;
+    value |= (byte & 0x7F) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return value;
+}
+
+/**
+ * Compares the len bytes at s with the null-terminated key,
+ * the same way strcmp would.
+ */
+static int cmpEncoded(const unsigned char *s, int len, const char *key) {
+  int keyLen = strlen(key);
+  int result = memcmp(s, key, len < keyLen ? len : keyLen);
+  if (result != 0) {
+    return result;
+  }
+  return len - keyLen;
+}
+
+StringStore* createStringStore(const char **strings, int n) {
+  if (strings == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid input (strings) \n");
+    return NULL;
+  }
+
+  const char **sorted = (const char **) malloc(sizeof(char *) * (n > 0 ? n : 1));
+  memcpy(sorted, strings, sizeof(char *) * n);
+  qsort(sorted, n, sizeof(char *), cmpStrings);
+
+  // drop duplicates
+  int unique = 0;
+  for (int i = 0; i < n; i++) {
+    if (unique == 0 || strcmp(sorted[unique - 1], sorted[i]) != 0) {
+      sorted[unique++] = sorted[i];
+    }
+  }
+
+  StringStore *store = (StringStore *) malloc(sizeof(StringStore));
+  int capacity = 64;
+  store->data = (unsigned char *) malloc(capacity);
+  store->dataSize = 0;
+  store->numStrings = unique;
+  store->numBlocks = (unique + STRING_STORE_BLOCK_SIZE - 1) / STRING_STORE_BLOCK_SIZE;
+  store->blockOffsets = (int *) malloc(sizeof(int) * (store->numBlocks > 0 ? store->numBlocks : 1));
+  store->maxLength = 0;
+
+  for (int i = 0; i < unique; i++) {
+    int len = strlen(sorted[i]);
+    int prefix = 0;
+    if (i % STRING_STORE_BLOCK_SIZE == 0) {
+      store->blockOffsets[i / STRING_STORE_BLOCK_SIZE] = store->dataSize;
+    } else {
+      const char *prev = sorted[i - 1];
+      while (prev[prefix] != '\0' && prev[prefix] == sorted[i][prefix]) {
+        prefix++;
+      }
+    }
+    if (len > store->maxLength) {
+      store->maxLength = len;
+    }
+
+    writeLength(store, &capacity, prefix);
+    writeLength(store, &capacity, len - prefix);
+    while (store->dataSize + len - prefix > capacity) {
+      capacity *= 2;
+      store->data = (unsigned char *) realloc(store->data, capacity);
+    }
+    memcpy(store->data + store->dataSize, sorted[i] + prefix, len - prefix);
+    store->dataSize += len - prefix;
+  }
+
+  // trim the arena down to its exact size
+  if (store->dataSize > 0) {
+    store->data = (unsigned char *) realloc(store->data, store->dataSize);
+  }
+
+  free(sorted);
+  return store;
+}
+
+int stringStoreFind(const StringStore *store, const char *str) {
+  if (store == NULL || str == NULL || store->numBlocks == 0) {
+    return -1;
+  }
+
+  // find the last block whose first string is <= str, block heads are
+  // stored in full so they can be compared in place
+  int lo = 0;
+  int hi = store->numBlocks - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    const unsigned char *p = store->data + store->blockOffsets[mid];
+    readLength(&p);
+    int len = readLength(&p);
+    if (cmpEncoded(p, len, str) <= 0) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  // walk the block comparing in place.  matched is how many leading
+  // characters the current entry shares with str; every entry before
+  // it is smaller than str
+  const unsigned char *p = store->data + store->blockOffsets[lo];
+  const unsigned char *key = (const unsigned char *) str;
+  int first = lo * STRING_STORE_BLOCK_SIZE;
+  int last = first + STRING_STORE_BLOCK_SIZE;
+  if (last > store->numStrings) {
+    last = store->numStrings;
+  }
+
+  int matched = 0;
+  for (int id = first; id < last; id++) {
+    int prefix = readLength(&p);
+    int suffix = readLength(&p);
+    const unsigned char *s = p;
+    p += suffix;
+
+    if (prefix > matched) {
+      // shares the character that made the previous entry smaller
+      continue;
+    } else if (prefix < matched) {
+      // differs from the previous entry, and so from str, by a larger character
+      return -1;
+    }
+
+    int i = 0;
+    while (i < suffix && key[matched] != '\0' && s[i] == key[matched]) {
+      i++;
+      matched++;
+    }
+    if (i == suffix) {
+      if (key[matched] == '\0') {
+        return id;
+      }
+      // this entry is a prefix of str, so it is smaller
+      continue;
+    }
+    if (key[matched] == '\0' || s[i] > key[matched]) {
+      return -1;
+    }
+  }
+
+  return -1;
+}
+
+int stringStoreGet(const StringStore *store, int id, char *buffer) {
+  if (store == NULL || buffer == NULL || id < 0 || id >= store->numStrings) {
+    return -1;
+  }
+
+  const unsigned char *p = store->data + store->blockOffsets[id / STRING_STORE_BLOCK_SIZE];
+  int len = 0;
+  for (int i = id - id % STRING_STORE_BLOCK_SIZE; i <= id; i++) {
+    int prefix = readLength(&p);
+    int suffix = readLength(&p);
+    memcpy(buffer + prefix, p, suffix);
+    p += suffix;
+    len = prefix + suffix;
+  }
+  buffer[len] = '\0';
+
+  return len;
+}
+
+long stringStoreMemoryUsage(const StringStore *store) {
+  if (store == NULL) {
+    return 0;
+  }
+  return sizeof(StringStore) + store->dataSize + sizeof(int) * (long) store->numBlocks;
+}
+
+void freeStringStore(StringStore *store) {
+  if (store != NULL) {
+    free(store->data);
+    free(store->blockOffsets);
+    free(store);
+  }
+}
+
+static StringStore* buildColumn(const char **column, int n, int *ids) {
+  StringStore *store = createStringStore(column, n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = stringStoreFind(store, column[i]);
+  }
+  return store;
+}
+
+AirportStrings* createAirportStrings(const Airport *airports, int n) {
+  if (airports == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid input (airports) \n");
+    return NULL;
+  }
+
+  AirportStrings *strings = (AirportStrings *) malloc(sizeof(AirportStrings));
+  int size = n > 0 ? n : 1;
+  strings->n = n;
+  strings->gpsIdIds = (int *) malloc(sizeof(int) * size);
+  strings->nameIds = (int *) malloc(sizeof(int) * size);
+  strings->cityIds = (int *) malloc(sizeof(int) * size);
+
+  const char **column = (const char **) malloc(sizeof(char *) * size);
+  for (int i = 0; i < n; i++) column[i] = airports[i].gpsId;
+  strings->gpsIds = buildColumn(column, n, strings->gpsIdIds);
+  for (int i = 0; i < n; i++) column[i] = airports[i].name;
+  strings->names = buildColumn(column, n, strings->nameIds);
+  for (int i = 0; i < n; i++) column[i] = airports[i].city;
+  strings->cities = buildColumn(column, n, strings->cityIds);
+  free(column);
+
+  return strings;
+}
+
+int airportStringsCmpByName(const AirportStrings *strings, int i, int j) {
+  return strings->nameIds[i] - strings->nameIds[j];
+}
+
+char* airportStringsToString(const AirportStrings *strings, const Airport *airports, int i) {
+  if (strings == NULL || airports == NULL || i < 0 || i >= strings->n) {
+    fprintf(stderr, "ERROR invalid input\n");
+    return NULL;
+  }
+
+  char *gpsId = (char *) malloc(sizeof(char) * (strings->gpsIds->maxLength + 1));
+  char *name = (char *) malloc(sizeof(char) * (strings->names->maxLength + 1));
+  char *city = (char *) malloc(sizeof(char) * (strings->cities->maxLength + 1));
+  stringStoreGet(strings->gpsIds, strings->gpsIdIds[i], gpsId);
+  stringStoreGet(strings->names, strings->nameIds[i], name);
+  stringStoreGet(strings->cities, strings->cityIds[i], city);
+
+  const Airport *a = &airports[i];
+  char temp[1000];
+  snprintf(temp, sizeof(temp), "%-8s %-15s %-20s %.2f %.2f %d %-10s %-2s", gpsId, a->type, name,
+           a->latitude, a->longitude, a->elevationFeet, city, a->countryAbbrv);
+  char* result = (char*)malloc(sizeof(char) * (strlen(temp) + 1));
+  strcpy(result, temp);
+
+  free(gpsId);
+  free(name);
+  free(city);
+  return result;
+}
+
+void printAirportsFromStrings(const AirportStrings *strings, const Airport *airports, int n) {
+  for (int i = 0; i < n; i++) {
+    char *s = airportStringsToString(strings, airports, i);
+    if (s != NULL) {
+      printf("%s\n", s);
+      free(s);
+    }
+  }
+
+  return;
+}
+
+void releaseAirportStringFields(Airport *airports, int n) {
+  if (airports == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < n; i++) {
+    free(airports[i].gpsId);
+    free(airports[i].name);
+    free(airports[i].city);
+    airports[i].gpsId = NULL;
+    airports[i].name = NULL;
+    airports[i].city = NULL;
+  }
+}
+
+void freeAirportStrings(AirportStrings *strings) {
+  if (strings != NULL) {
+    freeStringStore(strings->gpsIds);
+    freeStringStore(strings->names);
+    freeStringStore(strings->cities);
+    free(strings->gpsIdIds);
+    free(strings->nameIds);
+    free(strings->cityIds);
+    free(strings);
+  }
+}
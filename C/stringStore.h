@@ -0,0 +1,135 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method declarations for the compact string store
+ */
+
+
+
+#ifndef STRING_STORE_H
+#define STRING_STORE_H
+
+#include "airport.h"
+
+/**
+ * The number of strings in each front-coded block.  The first
+ * string of a block is stored in full, the rest only store the
+ * suffix that differs from the string before them.
+ */
+#define STRING_STORE_BLOCK_SIZE 16
+
+/**
+ * A sorted, de-duplicated, front-coded set of strings kept in a
+ * single arena.  Each entry is encoded as
+ *
+ *   [shared prefix length][suffix length][suffix bytes]
+ *
+ * with both lengths as variable length (7 bits per byte) integers.
+ * Strings are identified by their rank in sorted order, so two ids
+ * compare the same way the strings they stand for do.
+ */
+typedef struct {
+  unsigned char *data;
+  int *blockOffsets;
+  int numStrings;
+  int numBlocks;
+  int dataSize;
+  int maxLength;
+} StringStore;
+
+/**
+ * The gpsId, name and city columns of an airport table kept in
+ * StringStores, with one id per airport into each store.
+ */
+typedef struct {
+  StringStore *gpsIds;
+  StringStore *names;
+  StringStore *cities;
+  int *gpsIdIds;
+  int *nameIds;
+  int *cityIds;
+  int n;
+} AirportStrings;
+
+/**
+ * A factory function to create a new StringStore holding the
+ * distinct values of the n given strings.  The strings are copied.
+ */
+StringStore* createStringStore(const char **strings, int n);
+
+/**
+ * Finds the id of the given string.
+ *
+ * @param store the store to search
+ * @param str the string to look for
+ * @return the id of the string, or -1 if it is not in the store
+ */
+int stringStoreFind(const StringStore *store, const char *str);
+
+/**
+ * Decodes the string with the given id into buffer, which must be
+ * able to hold maxLength + 1 characters.
+ *
+ * @param store the store to decode from
+ * @param id the id of the string
+ * @param buffer where the null-terminated string is written
+ * @return the length of the string, or -1 if the id is invalid
+ */
+int stringStoreGet(const StringStore *store, int id, char *buffer);
+
+/**
+ * Returns the number of bytes the given store uses, including
+ * its arena and block index.
+ */
+long stringStoreMemoryUsage(const StringStore *store);
+
+/**
+ * Frees all the memory used by the given StringStore.
+ */
+void freeStringStore(StringStore *store);
+
+/**
+ * Builds compact string columns for the gpsId, name and city of
+ * each of the n given airports.
+ */
+AirportStrings* createAirportStrings(const Airport *airports, int n);
+
+/**
+ * A comparator-style function that orders airports i and j of the
+ * given table by name without decoding either name.
+ */
+int airportStringsCmpByName(const AirportStrings *strings, int i, int j);
+
+/**
+ * Constructs a new string representation of airport i of the given
+ * table, in the same format as airportToString(), reading its gpsId,
+ * name and city from the string columns rather than the Airport.
+ */
+char* airportStringsToString(const AirportStrings *strings, const Airport *airports, int i);
+
+/**
+ * Prints all the n airports of the given table, reading their gpsId,
+ * name and city from the string columns.
+ */
+void printAirportsFromStrings(const AirportStrings *strings, const Airport *airports, int n);
+
+/**
+ * Frees the gpsId, name and city of each of the n airports and sets
+ * them to NULL, once an AirportStrings has been built from them, so
+ * only the compact columns remain.  Use printAirportsFromStrings() and
+ * the AirportStrings ids to read them afterwards.  The airports must
+ * own their strings (see initAirport()) and must not share them with
+ * other Airport structures.  The functions in airport.h that read
+ * those fields (airportToString(), printAirports(), generateReports(),
+ * cmpByName(), cmpByNameDesc(), filterByCity() and grouping by
+ * GROUP_BY_COUNTRY_CITY) must not be used on the airports afterwards.
+ */
+void releaseAirportStringFields(Airport *airports, int n);
+
+/**
+ * Frees all the memory used by the given AirportStrings.
+ */
+void freeAirportStrings(AirportStrings *strings);
+
+#endif // STRING_STORE_H
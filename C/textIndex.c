@@ -0,0 +1,386 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method definitions for the Airport text index
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "textIndex.h"
+#include "airportIndex.h"
+
+#define NUM_TEXT_FIELDS 3
+
+typedef struct {
+  const char *key;
+  int row;
+} TextKey;
+
+/**
+ * The longest n-gram the index keeps posting lists for.  Shorter
+ * n-grams are indexed too, so one and two character queries are
+ * answered from their own list rather than by scanning every airport.
+ */
+#define MAX_GRAM_LENGTH 3
+
+typedef struct {
+  unsigned int gram;
+  int row;
+} GramEntry;
+
+static int cmpTextKey(const void* a, const void* b) {
+  const TextKey* _a = (const TextKey*)a;
+  const TextKey* _b = (const TextKey*)b;
+
+  int result = strcmp(_a->key, _b->key);
+  if (result != 0) {
+    return result;
+  }
+  return _a->row - _b->row;
+}
+
+static int cmpRows(const void* a, const void* b) {
+  return *(const int *)a - *(const int *)b;
+}
+
+static const char* textField(const Airport *a, int field) {
+  switch (field) {
+    case 0: return a->name;
+    case 1: return a->city;
+    default: return a->gpsId;
+  }
+}
+
+/**
+ * Sorts the entries by gram with a byte-wise LSD radix sort, which
+ * is stable, so entries collected in ascending row order come out
+ * with each gram's rows ascending.  There are a few entries per
+ * character of text, too many to qsort quickly.
+ */
+static void sortGramEntries(GramEntry *entries, int n) {
+  GramEntry *from = entries;
+  GramEntry *to = (GramEntry *) malloc(sizeof(GramEntry) * (n > 0 ? n : 1));
+  for (int shift = 0; shift < 32; shift += 8) {
+    int counts[257] = {0};
+    for (int i = 0; i < n; i++) {
+      counts[((from[i].gram >> shift) & 0xff) + 1]++;
+    }
+    for (int b = 0; b < 256; b++) {
+      counts[b + 1] += counts[b];
+    }
+    for (int i = 0; i < n; i++) {
+      to[counts[(from[i].gram >> shift) & 0xff]++] = from[i];
+    }
+    GramEntry *temp = from;
+    from = to;
+    to = temp;
+  }
+  // an even number of passes leaves the result back in entries
+  free(to);
+}
+
+/**
+ * Returns a newly allocated lowercase copy of the given string.
+ */
+static char* toLower(const char *str) {
+  int len = strlen(str);
+  char *result = (char *) malloc(sizeof(char) * (len + 1));
+  for (int i = 0; i <= len; i++) {
+    result[i] = tolower((unsigned char) str[i]);
+  }
+  return result;
+}
+
+/**
+ * Packs the length (1 to 3) and the characters of the n-gram at s
+ * into one key, so grams of every length share one sorted table.
+ */
+static unsigned int gramAt(const char *s, int length) {
+  unsigned int gram = (unsigned int) length << 24;
+  for (int i = 0; i < length; i++) {
+    gram |= (unsigned int)(unsigned char) s[i] << (8 * (length - 1 - i));
+  }
+  return gram;
+}
+
+/**
+ * Checks whether str contains lowerText, ignoring the case of str.
+ */
+static int containsIgnoreCase(const char *str, const char *lowerText) {
+  int textLen = strlen(lowerText);
+  for (const char *s = str; *s != '\0'; s++) {
+    int i = 0;
+    while (i < textLen && s[i] != '\0' && tolower((unsigned char) s[i]) == lowerText[i]) {
+      i++;
+    }
+    if (i == textLen) {
+      return 1;
+    }
+  }
+  return textLen == 0;
+}
+
+static int matchesAnyField(const Airport *a, const char *lowerText) {
+  for (int f = 0; f < NUM_TEXT_FIELDS; f++) {
+    if (containsIgnoreCase(textField(a, f), lowerText)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Sorts the given rows and removes duplicates, returning the
+ * new number of rows.
+ */
+static int sortUniqueRows(int *rows, int n) {
+  qsort(rows, n, sizeof(int), cmpRows);
+  int unique = 0;
+  for (int i = 0; i < n; i++) {
+    if (unique == 0 || rows[unique - 1] != rows[i]) {
+      rows[unique++] = rows[i];
+    }
+  }
+  return unique;
+}
+
+AirportTextIndex* createAirportTextIndex(const Airport *airports, int n) {
+  if (airports == NULL || n < 0) {
+    fprintf(stderr, "ERROR invalid input (airports) \n");
+    return NULL;
+  }
+
+  AirportTextIndex *index = (AirportTextIndex *) malloc(sizeof(AirportTextIndex));
+  index->airports = airports;
+  index->n = n;
+  index->numKeys = n * NUM_TEXT_FIELDS;
+
+  int numKeys = index->numKeys > 0 ? index->numKeys : 1;
+  TextKey *keys = (TextKey *) malloc(sizeof(TextKey) * numKeys);
+  int keyDataSize = 0;
+  int numGrams = 0;
+  for (int i = 0; i < n; i++) {
+    for (int f = 0; f < NUM_TEXT_FIELDS; f++) {
+      char *key = toLower(textField(&airports[i], f));
+      int len = strlen(key);
+      keys[i * NUM_TEXT_FIELDS + f].key = key;
+      keys[i * NUM_TEXT_FIELDS + f].row = i;
+      keyDataSize += len + 1;
+      for (int g = 1; g <= MAX_GRAM_LENGTH && g <= len; g++) {
+        numGrams += len - g + 1;
+      }
+    }
+  }
+
+  // collect every (gram, row) pair in row order, then sort them by
+  // gram so each gram's rows form one ascending run
+  GramEntry *entries = (GramEntry *) malloc(sizeof(GramEntry) * (numGrams > 0 ? numGrams : 1));
+  int numEntries = 0;
+  for (int k = 0; k < index->numKeys; k++) {
+    const char *key = keys[k].key;
+    for (int j = 0; key[j] != '\0'; j++) {
+      for (int g = 1; g <= MAX_GRAM_LENGTH && key[j + g - 1] != '\0'; g++) {
+        entries[numEntries].gram = gramAt(key + j, g);
+        entries[numEntries].row = keys[k].row;
+        numEntries++;
+      }
+    }
+  }
+  sortGramEntries(entries, numEntries);
+
+  index->grams = (unsigned int *) malloc(sizeof(unsigned int) * (numEntries > 0 ? numEntries : 1));
+  index->postingOffsets = (int *) malloc(sizeof(int) * (numEntries + 1));
+  index->postings = (int *) malloc(sizeof(int) * (numEntries > 0 ? numEntries : 1));
+  index->numGrams = 0;
+  int numPostings = 0;
+  for (int e = 0; e < numEntries; e++) {
+    if (e == 0 || entries[e].gram != entries[e - 1].gram) {
+      index->grams[index->numGrams] = entries[e].gram;
+      index->postingOffsets[index->numGrams] = numPostings;
+      index->numGrams++;
+    } else if (entries[e].row == entries[e - 1].row) {
+      // the same gram appears more than once for this airport
+      continue;
+    }
+    index->postings[numPostings++] = entries[e].row;
+  }
+  index->postingOffsets[index->numGrams] = numPostings;
+  free(entries);
+
+  // pack the sorted keys into one arena
+  qsort(keys, index->numKeys, sizeof(TextKey), cmpTextKey);
+  index->keyData = (char *) malloc(sizeof(char) * (keyDataSize > 0 ? keyDataSize : 1));
+  index->keyOffsets = (int *) malloc(sizeof(int) * numKeys);
+  index->keyRows = (int *) malloc(sizeof(int) * numKeys);
+  int offset = 0;
+  for (int k = 0; k < index->numKeys; k++) {
+    int len = strlen(keys[k].key);
+    memcpy(index->keyData + offset, keys[k].key, len + 1);
+    index->keyOffsets[k] = offset;
+    index->keyRows[k] = keys[k].row;
+    offset += len + 1;
+    free((char *) keys[k].key);
+  }
+  free(keys);
+
+  return index;
+}
+
+int* searchByPrefix(const AirportTextIndex *index, const char *prefix, int *output_size) {
+  if (index == NULL || prefix == NULL || output_size == NULL) {
+    return NULL;
+  }
+
+  char *lowerPrefix = toLower(prefix);
+  int prefixLen = strlen(lowerPrefix);
+
+  // find the first key >= prefix, every match follows it
+  int lo = 0;
+  int hi = index->numKeys;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (strcmp(index->keyData + index->keyOffsets[mid], lowerPrefix) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  int end = lo;
+  while (end < index->numKeys &&
+         strncmp(index->keyData + index->keyOffsets[end], lowerPrefix, prefixLen) == 0) {
+    end++;
+  }
+  free(lowerPrefix);
+
+  if (end == lo) {
+    return NULL;
+  }
+
+  int *result = (int *) malloc(sizeof(int) * (end - lo));
+  memcpy(result, index->keyRows + lo, sizeof(int) * (end - lo));
+  *output_size = sortUniqueRows(result, end - lo);
+  return result;
+}
+
+/**
+ * Returns the position of the given gram in the index, or -1.
+ */
+static int findGram(const AirportTextIndex *index, unsigned int gram) {
+  int lo = 0;
+  int hi = index->numGrams - 1;
+  while (lo <= hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (index->grams[mid] < gram) {
+      lo = mid + 1;
+    } else if (index->grams[mid] > gram) {
+      hi = mid - 1;
+    } else {
+      return mid;
+    }
+  }
+  return -1;
+}
+
+int* searchBySubstring(const AirportTextIndex *index, const char *text, int *output_size) {
+  if (index == NULL || text == NULL || output_size == NULL) {
+    return NULL;
+  }
+
+  char *lowerText = toLower(text);
+  int textLen = strlen(lowerText);
+  int *candidates = NULL;
+  int numCandidates = 0;
+
+  if (textLen == 0) {
+    // every airport contains the empty text
+    candidates = (int *) malloc(sizeof(int) * (index->n > 0 ? index->n : 1));
+    for (int i = 0; i < index->n; i++) {
+      candidates[numCandidates++] = i;
+    }
+  } else if (textLen < MAX_GRAM_LENGTH) {
+    // the text is a gram itself, so its posting list is the exact answer
+    int position = findGram(index, gramAt(lowerText, textLen));
+    free(lowerText);
+    if (position < 0) {
+      return NULL;
+    }
+    int found = index->postingOffsets[position + 1] - index->postingOffsets[position];
+    candidates = (int *) malloc(sizeof(int) * found);
+    memcpy(candidates, index->postings + index->postingOffsets[position], sizeof(int) * found);
+    *output_size = found;
+    return candidates;
+  } else {
+    // start from the shortest posting list and intersect the rest into it
+    int numQueryTrigrams = textLen - 2;
+    int *positions = (int *) malloc(sizeof(int) * numQueryTrigrams);
+    int shortest = 0;
+    for (int j = 0; j < numQueryTrigrams; j++) {
+      positions[j] = findGram(index, gramAt(lowerText + j, MAX_GRAM_LENGTH));
+      if (positions[j] < 0) {
+        free(positions);
+        free(lowerText);
+        return NULL;
+      }
+      int len = index->postingOffsets[positions[j] + 1] - index->postingOffsets[positions[j]];
+      int shortestLen = index->postingOffsets[positions[shortest] + 1] - index->postingOffsets[positions[shortest]];
+      if (len < shortestLen) {
+        shortest = j;
+      }
+    }
+
+    numCandidates = index->postingOffsets[positions[shortest] + 1] - index->postingOffsets[positions[shortest]];
+    candidates = (int *) malloc(sizeof(int) * numCandidates);
+    memcpy(candidates, index->postings + index->postingOffsets[positions[shortest]], sizeof(int) * numCandidates);
+    for (int j = 0; j < numQueryTrigrams && candidates != NULL; j++) {
+      if (j == shortest) {
+        continue;
+      }
+      const int *postings = index->postings + index->postingOffsets[positions[j]];
+      int numPostings = index->postingOffsets[positions[j] + 1] - index->postingOffsets[positions[j]];
+      int *next = intersectRows(candidates, numCandidates, postings, numPostings, &numCandidates);
+      free(candidates);
+      candidates = next;
+    }
+    free(positions);
+  }
+
+  if (candidates == NULL) {
+    free(lowerText);
+    return NULL;
+  }
+
+  // sharing every trigram does not guarantee the text appears in order,
+  // so confirm each candidate
+  int found = textLen == 0 ? numCandidates : 0;
+  for (int i = 0; textLen > 0 && i < numCandidates; i++) {
+    if (matchesAnyField(&index->airports[candidates[i]], lowerText)) {
+      candidates[found++] = candidates[i];
+    }
+  }
+  free(lowerText);
+
+  if (found == 0) {
+    free(candidates);
+    return NULL;
+  }
+
+  *output_size = found;
+  return candidates;
+}
+
+void freeAirportTextIndex(AirportTextIndex *index) {
+  if (index != NULL) {
+    free(index->keyData);
+    free(index->keyOffsets);
+    free(index->keyRows);
+    free(index->grams);
+    free(index->postingOffsets);
+    free(index->postings);
+    free(index);
+  }
+}
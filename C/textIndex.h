@@ -0,0 +1,83 @@
+/**
+ * Author: Max Schessler
+ * Date: 2024-12-2
+ *
+ * This file contains method declarations for the Airport text index
+ */
+
+
+
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+#include "airport.h"
+
+/**
+ * A case-insensitive search index over the name, city and gpsId
+ * of an airport table.
+ *
+ * For prefix search every field is lowercased and kept in sorted
+ * order (keyData/keyOffsets) next to the row it came from.
+ *
+ * For substring search every one, two and three character sequence
+ * (gram) of every lowercased field is mapped to the ascending list of
+ * rows that contain it.  Grams are packed with their length into one
+ * sorted key (see gramAt() in textIndex.c).  The lists for all grams
+ * live back to back in postings, with gram i owning
+ * postings[postingOffsets[i]] up to postings[postingOffsets[i + 1]].
+ *
+ * The index keeps a pointer to the airports it was built on, so it
+ * is only valid as long as they are.
+ */
+typedef struct {
+  const Airport *airports;
+  int n;
+
+  char *keyData;
+  int *keyOffsets;
+  int *keyRows;
+  int numKeys;
+
+  unsigned int *grams;
+  int *postingOffsets;
+  int *postings;
+  int numGrams;
+} AirportTextIndex;
+
+/**
+ * A factory function to create a new AirportTextIndex over the
+ * n given airports.
+ */
+AirportTextIndex* createAirportTextIndex(const Airport *airports, int n);
+
+/**
+ * Get the rows of the airports whose name, city or gpsId starts
+ * with the given prefix, ignoring case.
+ *
+ * @param index the index to search
+ * @param prefix the prefix to look for
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated ascending array of rows, or NULL if none match
+ */
+int* searchByPrefix(const AirportTextIndex *index, const char *prefix, int *output_size);
+
+/**
+ * Get the rows of the airports whose name, city or gpsId contains
+ * the given text, ignoring case.  Texts of one or two characters are
+ * answered straight from their posting list, longer ones by
+ * intersecting the lists of their trigrams and confirming each
+ * candidate.
+ *
+ * @param index the index to search
+ * @param text the text to look for
+ * @param output_size int passed by ref, will be output size of resulting array
+ * @return a newly allocated ascending array of rows, or NULL if none match
+ */
+int* searchBySubstring(const AirportTextIndex *index, const char *text, int *output_size);
+
+/**
+ * Frees all the memory used by the given AirportTextIndex.
+ */
+void freeAirportTextIndex(AirportTextIndex *index);
+
+#endif // TEXT_INDEX_H
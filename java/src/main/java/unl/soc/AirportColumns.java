@@ -0,0 +1,66 @@
+/**
+ * Author Max Schessler
+ * Date 2024-12-2
+ *
+ * This file holds my AirportColumns class
+ */
+
+package unl.soc;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.List;
+
+/**
+ * The AirportColumns class holds the numeric fields of a list of airports
+ * as off-heap columns (direct ByteBuffers in native byte order) that can be
+ * handed to the native library without copying.
+ */
+public class AirportColumns {
+
+	public final int size;
+	public final ByteBuffer latitudes;
+	public final ByteBuffer longitudes;
+	public final ByteBuffer elevations;
+
+	/**
+	 * Constructs the columns for the given airports.
+	 *
+	 * @param airports the airports to copy the numeric fields of
+	 */
+	public AirportColumns(List<Airport> airports) {
+		this.size = airports.size();
+		this.latitudes = allocateDoubles(size);
+		this.longitudes = allocateDoubles(size);
+		this.elevations = allocateDoubles(size);
+
+		for (int i = 0; i < size; i++) {
+			Airport a = airports.get(i);
+			latitudes.putDouble(i * Double.BYTES, a.latitude);
+			longitudes.putDouble(i * Double.BYTES, a.longitude);
+			elevations.putDouble(i * Double.BYTES, a.elevationFeet);
+		}
+	}
+
+	/**
+	 * Allocates an off-heap buffer for n doubles.
+	 */
+	public static ByteBuffer allocateDoubles(int n) {
+		return ByteBuffer.allocateDirect(n * Double.BYTES).order(ByteOrder.nativeOrder());
+	}
+
+	/**
+	 * Allocates an off-heap buffer for n chars.
+	 */
+	public static ByteBuffer allocateChars(int n) {
+		return ByteBuffer.allocateDirect(n * Character.BYTES).order(ByteOrder.nativeOrder());
+	}
+
+	/**
+	 * Allocates an off-heap buffer for n ints.
+	 */
+	public static ByteBuffer allocateInts(int n) {
+		return ByteBuffer.allocateDirect(n * Integer.BYTES).order(ByteOrder.nativeOrder());
+	}
+
+}
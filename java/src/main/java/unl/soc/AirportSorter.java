@@ -0,0 +1,200 @@
+/**
+ * Author Max Schessler
+ * Date 2024-12-2
+ *
+ * This file holds my AirportSorter class
+ */
+
+package unl.soc;
+
+import java.nio.ByteBuffer;
+import java.util.Comparator;
+import java.util.EnumMap;
+import java.util.IdentityHashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * The AirportSorter class sorts a list of airports by the orders of the
+ * AirportUtils comparators.  When libairport is available the sort keys of
+ * every airport are computed once into off-heap buffers and the list is
+ * sorted by the native kernels; otherwise, or if a native call fails, it
+ * falls back to List.sort with the matching comparator.  Both paths are
+ * stable and give the same order, for strings made of BMP characters.
+ */
+public class AirportSorter {
+
+	/**
+	 * The orders an AirportSorter can sort by, with the comparator each one
+	 * matches.
+	 */
+	public enum Key {
+		GPS_ID(AirportUtils.CMP_GPS_ID),
+		TYPE(AirportUtils.CMP_TYPE),
+		NAME(AirportUtils.CMP_NAME),
+		NAME_DESC(AirportUtils.CMP_NAME_DESC),
+		COUNTRY_CITY(AirportUtils.CMP_COUNTRY_CITY),
+		LATITUDE(AirportUtils.CMP_LATITUDE),
+		LONGITUDE(AirportUtils.CMP_LONGITUDE),
+		LINCOLN_DISTANCE(AirportUtils.CMP_LINCOLN_DISTANCE);
+
+		private final Comparator<Airport> comparator;
+
+		Key(Comparator<Airport> comparator) {
+			this.comparator = comparator;
+		}
+
+		public Comparator<Airport> comparator() {
+			return comparator;
+		}
+	}
+
+	/**
+	 * Case-folded string keys laid out for NativeAirportUtils.sortByStringKey.
+	 */
+	private static class StringKeys {
+		ByteBuffer chars;
+		int numChars;
+		ByteBuffer offsets;
+	}
+
+	private static final Airport LINCOLN_AIRPORT = new Airport("0R2", "Lincoln Municipal Airport",
+			40.846176, -96.75471, "small_airport", 4403, "Lincoln", "USA");
+
+	private final List<Airport> airports;
+	private final Airport[] rows;
+	private final Map<Airport, Integer> rowOf = new IdentityHashMap<>();
+	private final Map<Key, Object> keys = new EnumMap<>(Key.class);
+	private final ByteBuffer order;
+
+	/**
+	 * Constructs a sorter for the given list, which is sorted in place.
+	 *
+	 * @param airports the airports to sort
+	 */
+	public AirportSorter(List<Airport> airports) {
+		this.airports = airports;
+		this.rows = airports.toArray(new Airport[0]);
+		for (int i = 0; i < rows.length; i++) {
+			rowOf.put(rows[i], i);
+		}
+		this.order = NativeAirportUtils.isAvailable() ? AirportColumns.allocateInts(Math.max(rows.length, 1)) : null;
+	}
+
+	/**
+	 * Returns whether sort() uses the native kernels.
+	 */
+	public boolean isNative() {
+		return order != null;
+	}
+
+	/**
+	 * Stably sorts the list by the given key, like
+	 * airports.sort(key.comparator()).
+	 */
+	public void sort(Key key) {
+		int n = airports.size();
+		if (order == null || n < 2 || n != rows.length || !sortNative(key, n)) {
+			airports.sort(key.comparator());
+			return;
+		}
+
+		Airport[] sorted = new Airport[n];
+		for (int i = 0; i < n; i++) {
+			sorted[i] = rows[order.getInt(i * Integer.BYTES)];
+		}
+		for (int i = 0; i < n; i++) {
+			airports.set(i, sorted[i]);
+		}
+	}
+
+	private boolean sortNative(Key key, int n) {
+		// start from the list's current order so ties keep it, as List.sort does
+		for (int i = 0; i < n; i++) {
+			Integer row = rowOf.get(airports.get(i));
+			if (row == null) {
+				return false;
+			}
+			order.putInt(i * Integer.BYTES, row);
+		}
+
+		switch (key) {
+			case LATITUDE:
+				return NativeAirportUtils.sortByDoubleKey(doubleKeys(key), n, true, order) == 0;
+			case LONGITUDE:
+			case LINCOLN_DISTANCE:
+				return NativeAirportUtils.sortByDoubleKey(doubleKeys(key), n, false, order) == 0;
+			default:
+				StringKeys k = stringKeys(key == Key.NAME_DESC ? Key.NAME : key);
+				return NativeAirportUtils.sortByStringKey(k.chars, k.numChars, k.offsets, n,
+						key == Key.NAME_DESC, order) == 0;
+		}
+	}
+
+	private ByteBuffer doubleKeys(Key key) {
+		ByteBuffer values = (ByteBuffer) keys.get(key);
+		if (values != null) {
+			return values;
+		}
+
+		values = AirportColumns.allocateDoubles(rows.length);
+		for (int i = 0; i < rows.length; i++) {
+			double value;
+			if (key == Key.LATITUDE) {
+				value = rows[i].latitude;
+			} else if (key == Key.LONGITUDE) {
+				value = rows[i].longitude;
+			} else {
+				// the same function CMP_LINCOLN_DISTANCE uses, but only once per airport
+				value = Airport.airDistanceBetweenTwoStops(rows[i], LINCOLN_AIRPORT);
+			}
+			values.putDouble(i * Double.BYTES, value);
+		}
+		keys.put(key, values);
+		return values;
+	}
+
+	private static String stringKey(Airport a, Key key) {
+		switch (key) {
+			case GPS_ID: return a.gspId;
+			case TYPE: return a.type;
+			case NAME: return a.name;
+			// '\0' sorts before any other char, so countries compare first
+			default: return a.country + '\0' + a.city;
+		}
+	}
+
+	private StringKeys stringKeys(Key key) {
+		StringKeys k = (StringKeys) keys.get(key);
+		if (k != null) {
+			return k;
+		}
+
+		String[] strings = new String[rows.length];
+		int numChars = 0;
+		for (int i = 0; i < rows.length; i++) {
+			strings[i] = stringKey(rows[i], key);
+			numChars += strings[i].length();
+		}
+
+		k = new StringKeys();
+		k.numChars = numChars;
+		k.chars = AirportColumns.allocateChars(Math.max(numChars, 1));
+		k.offsets = AirportColumns.allocateInts(rows.length + 1);
+		int offset = 0;
+		for (int i = 0; i < rows.length; i++) {
+			k.offsets.putInt(i * Integer.BYTES, offset);
+			String s = strings[i];
+			for (int j = 0; j < s.length(); j++) {
+				// the same folding String.compareToIgnoreCase does per char
+				char c = Character.toLowerCase(Character.toUpperCase(s.charAt(j)));
+				k.chars.putChar((offset + j) * Character.BYTES, c);
+			}
+			offset += s.length();
+		}
+		k.offsets.putInt(rows.length * Integer.BYTES, offset);
+		keys.put(key, k);
+		return k;
+	}
+
+}
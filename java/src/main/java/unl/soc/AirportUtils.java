@@ -128,52 +128,55 @@ public class AirportUtils {
 
 	/**
 	 * A function that generates and prints several reports on the given list of
-	 * Airports.
+	 * Airports.  The sorts run on the native kernels when libairport is
+	 * available, see AirportSorter.
 	 */
 	public static void generateReports(List<Airport> airports) {
 
+		AirportSorter sorter = new AirportSorter(airports);
+
 		System.out.printf("Airports (original): \n");
 		System.out.printf("==============================\n");
 		printList(airports);
 
 		System.out.printf("\nAirports By GPS ID: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_GPS_ID);
+		sorter.sort(AirportSorter.Key.GPS_ID);
 		printList(airports);
 
 		System.out.printf("\nAirports By Type: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_TYPE);
+		sorter.sort(AirportSorter.Key.TYPE);
 		printList(airports);
 
 		System.out.printf("\nAirports By Name: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_NAME);
+		sorter.sort(AirportSorter.Key.NAME);
 		printList(airports);
 
 		System.out.printf("\nAirports By Name - Reversed: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_NAME_DESC);
+		sorter.sort(AirportSorter.Key.NAME_DESC);
 		printList(airports);
 
 		System.out.printf("\nAirports By Country/City: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_COUNTRY_CITY);
+		sorter.sort(AirportSorter.Key.COUNTRY_CITY);
 		printList(airports);
 
 		System.out.printf("\nAirports By Latitude: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_LATITUDE);
+		sorter.sort(AirportSorter.Key.LATITUDE);
 		printList(airports);
 
 		System.out.printf("\nAirports By Longitude: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_LONGITUDE);
+		sorter.sort(AirportSorter.Key.LONGITUDE);
 		printList(airports);
 
 		System.out.printf("\nAirports By Distance from Lincoln: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_LINCOLN_DISTANCE);
+		sorter.sort(AirportSorter.Key.LINCOLN_DISTANCE);
 		printList(airports);
 
 		System.out.printf("\nClosest Airport to Lincoln: \n");
@@ -186,7 +189,7 @@ public class AirportUtils {
 
 		System.out.printf("\nEast-West Geographic Center: \n");
 		System.out.printf("==============================\n");
-		airports.sort(CMP_LONGITUDE);
+		sorter.sort(AirportSorter.Key.LONGITUDE);
 		System.out.println(airports.get(airports.size()/2));
 
 
@@ -0,0 +1,110 @@
+/**
+ * Author Max Schessler
+ * Date 2024-12-2
+ *
+ * This file holds my NativeAirportUtils class.
+ */
+
+package unl.soc;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Bindings to the batch routines of the C airport library (libairport),
+ * see C/airportJni.c for how to build it.  All buffers must be direct
+ * buffers in native byte order, such as those of AirportColumns.
+ * The native methods may only be called when isAvailable() is true.
+ */
+public class NativeAirportUtils {
+
+	private static final boolean AVAILABLE = loadLibrary();
+
+	private static boolean loadLibrary() {
+		try {
+			System.loadLibrary("airport");
+			return true;
+		} catch (UnsatisfiedLinkError | SecurityException e) {
+			return false;
+		}
+	}
+
+	/**
+	 * Returns whether libairport could be loaded.
+	 */
+	public static boolean isAvailable() {
+		return AVAILABLE;
+	}
+
+	/**
+	 * Computes the air distance, in kilometers, from the origin to each of the
+	 * n points.  Points with an invalid latitude or longitude get -1.
+	 *
+	 * @return 0 on success, -1 on invalid input
+	 */
+	public static native int airDistances(ByteBuffer latitudes, ByteBuffer longitudes, int n,
+			double originLatitude, double originLongitude, ByteBuffer distances);
+
+	/**
+	 * Writes the positions of the n points into order, sorted by their air
+	 * distance from the origin, closest first.
+	 *
+	 * @return 0 on success, -1 on invalid input
+	 */
+	public static native int sortByAirDistance(ByteBuffer latitudes, ByteBuffer longitudes, int n,
+			double originLatitude, double originLongitude, ByteBuffer order);
+
+	/**
+	 * Writes the positions of the values in [min, max] into rows.
+	 *
+	 * @return the number of positions written, or -1 on invalid input
+	 */
+	public static native int filterByRange(ByteBuffer values, int n, double min, double max, ByteBuffer rows);
+
+	/**
+	 * Stably sorts the n row numbers in order by keys[row], ascending or
+	 * descending.  Rows with equal keys keep their relative order.
+	 *
+	 * @return 0 on success, -1 on invalid input
+	 * @throws IllegalArgumentException if a buffer is too small or a row
+	 *         number in order is not in [0, n)
+	 */
+	public static native int sortByDoubleKey(ByteBuffer keys, int n, boolean descending, ByteBuffer order);
+
+	/**
+	 * Stably sorts the n row numbers in order by a string key.  The key of
+	 * row r is the chars from offsets[r] up to offsets[r + 1] in chars,
+	 * compared char by char.
+	 *
+	 * @param numChars the number of chars in chars
+	 * @return 0 on success, -1 on invalid input
+	 * @throws IllegalArgumentException if a buffer is too small, the offsets
+	 *         are not ascending within chars, or a row number in order is
+	 *         not in [0, n)
+	 */
+	public static native int sortByStringKey(ByteBuffer chars, int numChars, ByteBuffer offsets, int n,
+			boolean descending, ByteBuffer order);
+
+	/**
+	 * Returns the given airports ordered by their distance from Lincoln
+	 * Municipal Airport (0R2, 40.846176, -96.75471), closest first.  This is
+	 * meant to match AirportUtils.CMP_LINCOLN_DISTANCE, but C and Java trig
+	 * may differ in the last bit, so airports at almost the same distance can
+	 * come out swapped.  NativeBenchmark reports how often that happens.
+	 */
+	public static List<Airport> sortByLincolnDistance(List<Airport> airports, AirportColumns columns) {
+		ByteBuffer order = AirportColumns.allocateInts(columns.size);
+		if (sortByAirDistance(columns.latitudes, columns.longitudes, columns.size,
+				40.846176, -96.75471, order) != 0) {
+			return null;
+		}
+
+		List<Airport> result = new ArrayList<>(columns.size);
+		for (int i = 0; i < columns.size; i++) {
+			result.add(airports.get(order.getInt(i * Integer.BYTES)));
+		}
+		return result;
+	}
+
+}
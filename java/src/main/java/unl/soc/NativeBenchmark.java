@@ -0,0 +1,141 @@
+/**
+ * Author Max Schessler
+ * Date 2024-12-2
+ *
+ * This file holds my benchmark of the pure Java and native airport routines.
+ */
+
+package unl.soc;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Random;
+
+public class NativeBenchmark {
+
+	private static final int ROUNDS = 5;
+
+	/**
+	 * Every Java variant adds its result in here, and it is printed at the
+	 * end, so the JIT cannot drop the work as dead code.
+	 */
+	private static double sink;
+
+	public static void main(String[] args) {
+		int n = args.length > 0 ? Math.max(1, Integer.parseInt(args[0])) : 100000;
+
+		Random random = new Random(42);
+		List<Airport> airports = new ArrayList<>(n);
+		for (int i = 0; i < n; i++) {
+			airports.add(new Airport("A" + i, "Airport " + i, random.nextDouble() * 180 - 90,
+					random.nextDouble() * 360 - 180, "small_airport", random.nextInt(10000), "City", "US"));
+		}
+		AirportColumns columns = new AirportColumns(airports);
+		ByteBuffer distances = AirportColumns.allocateDoubles(n);
+		ByteBuffer rows = AirportColumns.allocateInts(n);
+		Airport lincoln = new Airport("0R2", "Lincoln Municipal Airport",
+				40.846176, -96.75471, "small_airport", 4403, "Lincoln", "USA");
+
+		if (!NativeAirportUtils.isAvailable()) {
+			System.err.println("libairport could not be loaded, see C/airportJni.c");
+			return;
+		}
+
+		System.out.printf("Benchmarking %d airports, best of %d rounds\n", n, ROUNDS);
+		System.out.printf("==============================\n");
+
+		report("Distances (Java)", () -> {
+			double[] result = new double[n];
+			for (int i = 0; i < n; i++) {
+				result[i] = Airport.airDistanceBetweenTwoStops(airports.get(i), lincoln);
+			}
+			double sum = 0;
+			for (double d : result) {
+				sum += d;
+			}
+			sink += sum;
+		});
+		report("Distances (native)", () -> NativeAirportUtils.airDistances(columns.latitudes,
+				columns.longitudes, n, lincoln.latitude, lincoln.longitude, distances));
+
+		report("Sort by Lincoln distance (Java)", () -> {
+			List<Airport> copy = new ArrayList<>(airports);
+			copy.sort(AirportUtils.CMP_LINCOLN_DISTANCE);
+			sink += copy.get(0).latitude;
+		});
+		report("Sort by Lincoln distance (native)", () -> NativeAirportUtils.sortByLincolnDistance(airports, columns));
+
+		report("All report sorts (Java)", () -> {
+			List<Airport> copy = new ArrayList<>(airports);
+			for (AirportSorter.Key key : AirportSorter.Key.values()) {
+				copy.sort(key.comparator());
+			}
+			sink += copy.get(0).latitude;
+		});
+		report("All report sorts (native)", () -> {
+			List<Airport> copy = new ArrayList<>(airports);
+			AirportSorter sorter = new AirportSorter(copy);
+			for (AirportSorter.Key key : AirportSorter.Key.values()) {
+				sorter.sort(key);
+			}
+		});
+
+		report("Filter latitude 30 to 45 (Java)", () -> {
+			List<Airport> result = new ArrayList<>();
+			for (Airport a : airports) {
+				if (a.latitude >= 30 && a.latitude <= 45) {
+					result.add(a);
+				}
+			}
+			sink += result.size();
+		});
+		report("Filter latitude 30 to 45 (native)", () -> NativeAirportUtils.filterByRange(columns.latitudes,
+				n, 30, 45, rows));
+
+		System.out.printf("\nNative vs Java orders: \n");
+		System.out.printf("==============================\n");
+		List<Airport> javaOrder = new ArrayList<>(airports);
+		List<Airport> nativeOrder = new ArrayList<>(airports);
+		AirportSorter sorter = new AirportSorter(nativeOrder);
+		for (AirportSorter.Key key : AirportSorter.Key.values()) {
+			javaOrder.sort(key.comparator());
+			sorter.sort(key);
+			System.out.printf("%-36s %10d differ\n", key, countDifferences(javaOrder, nativeOrder));
+		}
+
+		javaOrder = new ArrayList<>(airports);
+		javaOrder.sort(AirportUtils.CMP_LINCOLN_DISTANCE);
+		System.out.printf("%-36s %10d differ\n", "sortByLincolnDistance",
+				countDifferences(javaOrder, NativeAirportUtils.sortByLincolnDistance(airports, columns)));
+
+		System.out.printf("\n(checksum %.3f)\n", sink);
+	}
+
+	/**
+	 * Counts the positions at which the two lists hold different airports.
+	 */
+	private static int countDifferences(List<Airport> a, List<Airport> b) {
+		int count = 0;
+		for (int i = 0; i < a.size(); i++) {
+			if (a.get(i) != b.get(i)) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * Runs the given task ROUNDS times and prints the fastest time.
+	 */
+	private static void report(String name, Runnable task) {
+		long best = Long.MAX_VALUE;
+		for (int r = 0; r < ROUNDS; r++) {
+			long start = System.nanoTime();
+			task.run();
+			best = Math.min(best, System.nanoTime() - start);
+		}
+		System.out.printf("%-36s %10.3f ms\n", name, best / 1e6);
+	}
+
+}